@@ -0,0 +1,389 @@
+//
+// CollectionsBenchmark
+//
+// Headless benchmark for the collection types.  Every member of List, Map,
+// Set, Queue, Stack and their iterators is invoked through GetMember, the
+// same entry point a macro uses, on collections of increasing size.  The
+// ToString rows measure ${variable}, which shows the count.  The Declare
+// rows measure /declare and /deletevar of an empty collection.  The report
+// lists the time and heap allocations per operation.
+//
+// Usage: CollectionsBenchmark [--sizes 100,1000] [--budget-ms 200]
+//                             [--filter list.Item] [--csv]
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+
+using namespace Benchmarks;
+
+namespace
+{
+    //
+    // Return the text of the n'th item placed in a collection.  Items are
+    // zero padded so that they sort in the order they were created.
+    //
+
+    std::string ItemName(size_t n)
+    {
+        char buffer[32];
+
+        std::snprintf(buffer, sizeof(buffer), "item%08zu", n);
+        return std::string(buffer);
+    }
+
+    //
+    // A pool of arguments spread over a range of indexes, used so that
+    // positional members don't always hit the same position.
+    //
+
+    class ArgumentPool
+    {
+    public:
+
+        ArgumentPool(size_t elements, std::string (*format)(size_t))
+        {
+            const size_t poolSize = 1024;
+
+            for (size_t i = 0; i < poolSize; ++i)
+            {
+                m_arguments.emplace_back(format((i * 7919) % elements));
+            }
+        }
+
+        char * Get(size_t n)
+        {
+            return m_arguments[n % m_arguments.size()].Get();
+        }
+
+    private:
+
+        std::vector<Argument> m_arguments;
+    };
+
+    //
+    // Runs and reports the benchmarks that pass the filter.
+    //
+
+    class Suite
+    {
+    public:
+
+        explicit Suite(const Options & options)
+            : m_options(options)
+        {
+        }
+
+        //
+        // Measure an operation that leaves the collection unchanged.
+        //
+
+        template<typename Op>
+        void Run(const char * typeName, const char * member, size_t elements, Op op)
+        {
+            if (Selected(typeName, member))
+            {
+                Report(m_options, typeName, member, elements, Measure(op, m_options.Budget));
+            }
+        }
+
+        //
+        // Measure an operation that must be undone after every call.
+        //
+
+        template<typename Op, typename Restore>
+        void RunEach(const char * typeName, const char * member, size_t elements, Op op, Restore restore)
+        {
+            if (Selected(typeName, member))
+            {
+                Report(m_options, typeName, member, elements, MeasureEach(op, restore, m_options.Budget));
+            }
+        }
+
+    private:
+
+        bool Selected(const char * typeName, const char * member) const
+        {
+            return m_options.Selected(std::string(typeName) + "." + member);
+        }
+
+        const Options & m_options;
+    };
+
+    //
+    // Append n items to a list, one GetMember call per item.
+    //
+
+    void Populate(const MQTypeVar & variable, const char * member, size_t elements)
+    {
+        for (size_t i = 0; i < elements; ++i)
+        {
+            Argument item(ItemName(i));
+            Invoke(variable, member, item.Get());
+        }
+    }
+
+    //
+    // Benchmark the members of an iterator returned by First.  Members
+    // common to all of the iterators are measured, plus Key if hasKey is
+    // true.
+    //
+
+    void BenchmarkIterator(Suite & suite, const char * typeName, const MQTypeVar & collection, size_t elements, bool hasKey)
+    {
+        MQTypeVar iterator = Invoke(collection, "First");
+
+        suite.Run(typeName, "Reset", elements, [&](size_t) { Invoke(iterator, "Reset"); });
+
+        suite.Run(typeName, "Advance", elements,
+            [&](size_t)
+            {
+                Invoke(iterator, "Advance");
+                if (Invoke(iterator, "IsEnd").Int)
+                {
+                    Invoke(iterator, "Reset");
+                }
+            });
+
+        Invoke(iterator, "Reset");
+
+        suite.Run(typeName, "IsEnd", elements, [&](size_t) { Invoke(iterator, "IsEnd"); });
+        suite.Run(typeName, "Value", elements, [&](size_t) { Invoke(iterator, "Value"); });
+
+        if (hasKey)
+        {
+            suite.Run(typeName, "Key", elements, [&](size_t) { Invoke(iterator, "Key"); });
+        }
+
+        MQTypeVar clone;
+        suite.RunEach(typeName, "Clone", elements,
+            [&](size_t) { clone = Invoke(iterator, "Clone"); },
+            [&](size_t) { Release(clone); });
+    }
+
+    //
+    // Benchmark every list and list iterator member.
+    //
+
+    void BenchmarkList(Suite & suite, size_t elements)
+    {
+        MQTypeVar list = Declare("list");
+        Populate(list, "Append", elements);
+
+        size_t middle = elements / 2;
+        Argument middleItem(ItemName(middle));
+        Argument middleIndex(std::to_string(middle));
+        Argument insertAtMiddle(std::to_string(middle) + ",inserted");
+        Argument restoreMiddle(std::to_string(middle) + "," + ItemName(middle));
+        Argument restoreHead("0," + ItemName(0));
+        Argument splice(std::to_string(middle) + ",10");
+        Argument replace(ItemName(middle) + ",replaced");
+        Argument unreplace("replaced," + ItemName(middle));
+        Argument appended("appended");
+        Argument delimiter(",");
+        ArgumentPool positions(elements, [](size_t n) { return std::to_string(n); });
+        MQTypeVar result;
+
+        suite.Run("list", "Count", elements, [&](size_t) { Invoke(list, "Count"); });
+        suite.Run("list", "ToString", elements, [&](size_t) { Format(list); });
+        suite.Run("list", "Contains", elements, [&](size_t) { Invoke(list, "Contains", middleItem.Get()); });
+        suite.Run("list", "Index", elements, [&](size_t) { Invoke(list, "Index", middleItem.Get()); });
+        suite.Run("list", "Item", elements, [&](size_t i) { Invoke(list, "Item", positions.Get(i)); });
+        suite.Run("list", "CountOf", elements, [&](size_t) { Invoke(list, "CountOf", middleItem.Get()); });
+        suite.Run("list", "Find", elements, [&](size_t) { Invoke(list, "Find", middleItem.Get()); });
+        suite.Run("list", "First", elements, [&](size_t) { Invoke(list, "First"); });
+        suite.Run("list", "Delimiter", elements, [&](size_t) { Invoke(list, "Delimiter", delimiter.Get()); });
+
+        suite.RunEach("list", "Splice", elements,
+            [&](size_t) { result = Invoke(list, "Splice", splice.Get()); },
+            [&](size_t) { Release(result); });
+
+        suite.Run("list", "Replace", elements,
+            [&](size_t i) { Invoke(list, "Replace", (i & 1) ? unreplace.Get() : replace.Get()); });
+
+        //
+        // Leave the replaced item in its original state if an odd number of
+        // replacements were run.
+        //
+
+        Invoke(list, "Replace", unreplace.Get());
+
+        suite.Run("list", "Reverse", elements, [&](size_t) { Invoke(list, "Reverse"); });
+        suite.Run("list", "Sort", elements, [&](size_t) { Invoke(list, "Sort"); });
+
+        suite.RunEach("list", "Insert", elements,
+            [&](size_t) { Invoke(list, "Insert", insertAtMiddle.Get()); },
+            [&](size_t) { Invoke(list, "Erase", middleIndex.Get()); });
+
+        suite.RunEach("list", "Erase", elements,
+            [&](size_t) { Invoke(list, "Erase", middleIndex.Get()); },
+            [&](size_t) { Invoke(list, "Insert", restoreMiddle.Get()); });
+
+        suite.RunEach("list", "Remove", elements,
+            [&](size_t) { Invoke(list, "Remove", middleItem.Get()); },
+            [&](size_t) { Invoke(list, "Insert", restoreMiddle.Get()); });
+
+        suite.RunEach("list", "Append", elements,
+            [&](size_t) { Invoke(list, "Append", appended.Get()); },
+            [&](size_t) { Invoke(list, "Tail"); });
+
+        suite.RunEach("list", "Head", elements,
+            [&](size_t) { Invoke(list, "Head"); },
+            [&](size_t) { Invoke(list, "Insert", restoreHead.Get()); });
+
+        suite.RunEach("list", "Tail", elements,
+            [&](size_t) { Invoke(list, "Tail"); },
+            [&](size_t) { Argument tail(ItemName(elements - 1)); Invoke(list, "Append", tail.Get()); });
+
+        BenchmarkIterator(suite, "listiterator", list, elements, false);
+
+        suite.RunEach("list", "Clear", elements,
+            [&](size_t) { Invoke(list, "Clear"); },
+            [&](size_t) { Populate(list, "Append", elements); });
+
+        Release(list);
+    }
+
+    //
+    // Benchmark every map and map iterator member.
+    //
+
+    void BenchmarkMap(Suite & suite, size_t elements)
+    {
+        MQTypeVar map = Declare("map");
+        for (size_t i = 0; i < elements; ++i)
+        {
+            Argument pair(ItemName(i) + ",value");
+            Invoke(map, "Add", pair.Get());
+        }
+
+        Argument middleKey(ItemName(elements / 2));
+        Argument middlePair(ItemName(elements / 2) + ",value");
+        ArgumentPool keys(elements, ItemName);
+
+        suite.Run("map", "Count", elements, [&](size_t) { Invoke(map, "Count"); });
+        suite.Run("map", "ToString", elements, [&](size_t) { Format(map); });
+        suite.Run("map", "Contains", elements, [&](size_t i) { Invoke(map, "Contains", keys.Get(i)); });
+        suite.Run("map", "Add", elements, [&](size_t) { Invoke(map, "Add", middlePair.Get()); });
+        suite.Run("map", "First", elements, [&](size_t) { Invoke(map, "First"); });
+        suite.Run("map", "Find", elements, [&](size_t i) { Invoke(map, "Find", keys.Get(i)); });
+
+        suite.RunEach("map", "Remove", elements,
+            [&](size_t) { Invoke(map, "Remove", middleKey.Get()); },
+            [&](size_t) { Invoke(map, "Add", middlePair.Get()); });
+
+        BenchmarkIterator(suite, "mapiterator", map, elements, true);
+
+        Release(map);
+    }
+
+    //
+    // Benchmark every set and set iterator member.
+    //
+
+    void BenchmarkSet(Suite & suite, size_t elements)
+    {
+        MQTypeVar set = Declare("set");
+        Populate(set, "Add", elements);
+
+        Argument middleItem(ItemName(elements / 2));
+        ArgumentPool items(elements, ItemName);
+
+        suite.Run("set", "Count", elements, [&](size_t) { Invoke(set, "Count"); });
+        suite.Run("set", "ToString", elements, [&](size_t) { Format(set); });
+        suite.Run("set", "Contains", elements, [&](size_t i) { Invoke(set, "Contains", items.Get(i)); });
+        suite.Run("set", "Add", elements, [&](size_t) { Invoke(set, "Add", middleItem.Get()); });
+        suite.Run("set", "First", elements, [&](size_t) { Invoke(set, "First"); });
+        suite.Run("set", "Find", elements, [&](size_t i) { Invoke(set, "Find", items.Get(i)); });
+
+        suite.RunEach("set", "Remove", elements,
+            [&](size_t) { Invoke(set, "Remove", middleItem.Get()); },
+            [&](size_t) { Invoke(set, "Add", middleItem.Get()); });
+
+        BenchmarkIterator(suite, "setiterator", set, elements, false);
+
+        Release(set);
+    }
+
+    //
+    // Benchmark the queue and stack members.  Both types share the same
+    // member names.
+    //
+
+    void BenchmarkPushPop(Suite & suite, const char * typeName, size_t elements)
+    {
+        MQTypeVar collection = Declare(typeName);
+        Populate(collection, "Push", elements);
+
+        Argument pushed(ItemName(elements));
+
+        suite.Run(typeName, "Count", elements, [&](size_t) { Invoke(collection, "Count"); });
+        suite.Run(typeName, "ToString", elements, [&](size_t) { Format(collection); });
+        suite.Run(typeName, "IsEmpty", elements, [&](size_t) { Invoke(collection, "IsEmpty"); });
+        suite.Run(typeName, "Peek", elements, [&](size_t) { Invoke(collection, "Peek"); });
+
+        suite.RunEach(typeName, "Push", elements,
+            [&](size_t) { Invoke(collection, "Push", pushed.Get()); },
+            [&](size_t) { Invoke(collection, "Pop"); });
+
+        suite.RunEach(typeName, "Pop", elements,
+            [&](size_t) { Invoke(collection, "Pop"); },
+            [&](size_t) { Invoke(collection, "Push", pushed.Get()); });
+
+        Release(collection);
+    }
+
+    //
+    // Benchmark declaring and deleting an empty collection of each type, as
+    // a macro does with a collection local to a loop.
+    //
+
+    void BenchmarkDeclare(Suite & suite)
+    {
+        for (const char * typeName : { "list", "map", "set", "queue", "stack" })
+        {
+            suite.Run(typeName, "Declare", 0,
+                [&](size_t)
+                {
+                    MQTypeVar variable = Declare(typeName);
+                    Release(variable);
+                });
+        }
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    Options options;
+
+    if (!options.Parse(argc, argv))
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--sizes 100,1000,...] [--budget-ms n] [--filter type.Member] [--csv]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    RegisterTypes();
+
+    Suite suite(options);
+    ReportHeader(options);
+
+    BenchmarkDeclare(suite);
+
+    for (size_t elements : options.Sizes)
+    {
+        BenchmarkList(suite, elements);
+        BenchmarkMap(suite, elements);
+        BenchmarkSet(suite, elements);
+        BenchmarkPushPop(suite, "queue", elements);
+        BenchmarkPushPop(suite, "stack", elements);
+    }
+
+    UnregisterTypes();
+
+    return 0;
+}
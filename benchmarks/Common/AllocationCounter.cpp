@@ -0,0 +1,22 @@
+//
+// Report the allocation totals counted by the allocation functions in
+// AllocationAccounting.cpp.
+//
+
+#include "AllocationAccounting.h"
+#include "AllocationCounter.h"
+
+//
+// Return the current allocation totals.
+//
+
+Benchmarks::AllocationCount Benchmarks::CurrentAllocations()
+{
+    auto totals = Diagnostics::AllocationAccounting::ProcessTotals();
+
+    return AllocationCount
+    {
+        totals.Allocations,
+        totals.Bytes
+    };
+}
@@ -0,0 +1,31 @@
+//
+// AllocationCounter.h
+//
+// Count heap allocations made through the global operator new.  The
+// counting allocation functions are part of the collection core (see
+// plugin/AllocationAccounting.h).
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmarks
+{
+    //
+    // Snapshot of the number of allocations and bytes allocated since the
+    // process started.
+    //
+
+    struct AllocationCount
+    {
+        uint64_t Allocations;
+        uint64_t Bytes;
+    };
+
+    //
+    // Return the current allocation totals.
+    //
+
+    AllocationCount CurrentAllocations();
+}  // namespace Benchmarks
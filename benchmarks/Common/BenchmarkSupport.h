@@ -0,0 +1,311 @@
+//
+// BenchmarkSupport.h
+//
+// Drive the collection types through the MQ2 type interface the same way
+// a macro does and measure the time and allocations each member costs.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "MQ2CollectionsImpl.h"
+#include "Types.h"
+#include "AllocationCounter.h"
+
+namespace Benchmarks
+{
+    //
+    // Create a new variable of a registered type, as /declare does.  The
+    // returned variable's Type is the type descriptor.
+    //
+
+    inline MQTypeVar Declare(const char * typeName)
+    {
+        MQTypeVar variable;
+
+        variable.Type = Types::TypeMap::GetTypeInstanceForTypeName(typeName);
+        if (variable.Type == nullptr)
+        {
+            std::fprintf(stderr, "Type %s is not registered.\n", typeName);
+            std::exit(1);
+        }
+
+        variable.Type->InitVariable(variable);
+        return variable;
+    }
+
+    //
+    // Release a variable created by Declare or returned by a member that
+    // transfers ownership (Splice, Clone).
+    //
+
+    inline void Release(MQTypeVar & variable)
+    {
+        if (variable.Type != nullptr)
+        {
+            variable.Type->FreeVariable(variable);
+        }
+    }
+
+    //
+    // Invoke a member on a variable and return the result.
+    //
+
+    inline MQTypeVar Invoke(const MQTypeVar & variable, const char * member, char * index = nullptr)
+    {
+        MQTypeVar dest;
+
+        dest.Ptr = nullptr;
+        dest.Type = nullptr;
+        variable.Type->GetMember(variable, member, index, dest);
+
+        return dest;
+    }
+
+    //
+    // Convert a variable to the text a macro sees for ${variable}.
+    //
+
+    inline void Format(const MQTypeVar & variable)
+    {
+        char text[MAX_STRING];
+
+        variable.Type->ToString(variable, text);
+    }
+
+    //
+    // A mutable copy of a member argument.  GetMember takes a non-const
+    // Index so the text must live in writable storage.
+    //
+
+    class Argument
+    {
+    public:
+
+        explicit Argument(const std::string & text)
+            : m_text(text.begin(), text.end())
+        {
+            m_text.push_back('\0');
+        }
+
+        char * Get()
+        {
+            return m_text.data();
+        }
+
+    private:
+
+        std::vector<char> m_text;
+    };
+
+    //
+    // Result of measuring one operation.
+    //
+
+    struct Measurement
+    {
+        size_t Operations;
+        double NanosecondsPerOp;
+        double AllocationsPerOp;
+        double BytesPerOp;
+    };
+
+    //
+    // Options common to the benchmark executables.
+    //
+
+    struct Options
+    {
+        std::vector<size_t> Sizes { 100, 1000, 10000, 100000, 1000000 };
+        std::chrono::milliseconds Budget { 200 };
+        std::string Filter;
+        bool Csv = false;
+
+        //
+        // Parse --sizes a,b,c --budget-ms n --filter text --csv.  Return
+        // false if the arguments are not understood.
+        //
+
+        bool Parse(int argc, char ** argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string arg(argv[i]);
+
+                if ((arg == "--sizes") && (i + 1 < argc))
+                {
+                    Sizes.clear();
+
+                    char * cursor = argv[++i];
+                    while (*cursor)
+                    {
+                        Sizes.push_back((size_t) std::strtoull(cursor, &cursor, 10));
+                        if (*cursor == ',')
+                        {
+                            ++cursor;
+                        }
+                    }
+                }
+                else if ((arg == "--budget-ms") && (i + 1 < argc))
+                {
+                    Budget = std::chrono::milliseconds(std::atoi(argv[++i]));
+                }
+                else if ((arg == "--filter") && (i + 1 < argc))
+                {
+                    Filter = argv[++i];
+                }
+                else if (arg == "--csv")
+                {
+                    Csv = true;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        //
+        // Return true if a benchmark name passes the filter.
+        //
+
+        bool Selected(const std::string & name) const
+        {
+            return Filter.empty() || (name.find(Filter) != std::string::npos);
+        }
+    };
+
+    //
+    // Run op repeatedly, in batches of doubling size, until the time budget
+    // is spent or maxOps operations have been run.  op is passed the
+    // operation number.
+    //
+
+    template<typename Op>
+    Measurement Measure(Op op, std::chrono::milliseconds budget, size_t maxOps = 10000000)
+    {
+        using clock = std::chrono::steady_clock;
+
+        size_t operations = 0;
+        size_t batch = 1;
+        clock::duration elapsed(0);
+
+        AllocationCount before = CurrentAllocations();
+
+        while ((elapsed < budget) && (operations < maxOps))
+        {
+            auto start = clock::now();
+            for (size_t i = 0; i < batch; ++i)
+            {
+                op(operations + i);
+            }
+
+            elapsed += clock::now() - start;
+            operations += batch;
+            batch *= 2;
+        }
+
+        AllocationCount after = CurrentAllocations();
+
+        return Measurement
+        {
+            operations,
+            (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / operations,
+            (double) (after.Allocations - before.Allocations) / operations,
+            (double) (after.Bytes - before.Bytes) / operations
+        };
+    }
+
+    //
+    // Measure an operation that changes the collection, running restore
+    // after each operation to put the collection back into its original
+    // state.  Only op is timed and counted.  The total time spent,
+    // including restore, is capped at four times the budget.
+    //
+
+    template<typename Op, typename Restore>
+    Measurement MeasureEach(Op op, Restore restore, std::chrono::milliseconds budget, size_t maxOps = 1000000)
+    {
+        using clock = std::chrono::steady_clock;
+
+        size_t operations = 0;
+        clock::duration elapsed(0);
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+        auto wallStart = clock::now();
+
+        while ((elapsed < budget) && (operations < maxOps) && (clock::now() - wallStart < budget * 4))
+        {
+            AllocationCount before = CurrentAllocations();
+            auto start = clock::now();
+
+            op(operations);
+
+            elapsed += clock::now() - start;
+            AllocationCount after = CurrentAllocations();
+            allocations += after.Allocations - before.Allocations;
+            bytes += after.Bytes - before.Bytes;
+
+            restore(operations);
+            ++operations;
+        }
+
+        return Measurement
+        {
+            operations,
+            (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / operations,
+            (double) allocations / operations,
+            (double) bytes / operations
+        };
+    }
+
+    //
+    // Print the report header.
+    //
+
+    inline void ReportHeader(const Options & options)
+    {
+        if (options.Csv)
+        {
+            std::printf("type,member,elements,operations,ns_per_op,allocs_per_op,bytes_per_op\n");
+        }
+        else
+        {
+            std::printf("%-14s %-10s %10s %12s %12s %10s %10s\n",
+                        "type", "member", "elements", "operations", "ns/op", "allocs/op", "bytes/op");
+        }
+    }
+
+    //
+    // Print one measurement.
+    //
+
+    inline void Report(const Options & options,
+                       const char * typeName,
+                       const char * member,
+                       size_t elements,
+                       const Measurement & result)
+    {
+        const char * format = options.Csv
+            ? "%s,%s,%zu,%zu,%.1f,%.2f,%.1f\n"
+            : "%-14s %-10s %10zu %12zu %12.1f %10.2f %10.1f\n";
+
+        std::printf(format,
+                    typeName,
+                    member,
+                    elements,
+                    result.Operations,
+                    result.NanosecondsPerOp,
+                    result.AllocationsPerOp,
+                    result.BytesPerOp);
+        std::fflush(stdout);
+    }
+}  // namespace Benchmarks
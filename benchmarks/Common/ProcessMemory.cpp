@@ -0,0 +1,96 @@
+//
+// Report the resident memory of the benchmark process.
+//
+
+#include "ProcessMemory.h"
+
+#if defined(_WIN32)
+
+#include <windows.h>
+#include <psapi.h>
+
+#pragma comment(lib, "psapi.lib")
+
+namespace
+{
+    PROCESS_MEMORY_COUNTERS MemoryCounters()
+    {
+        PROCESS_MEMORY_COUNTERS counters = { 0 };
+
+        counters.cb = sizeof(counters);
+        GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+
+        return counters;
+    }
+}
+
+uint64_t Benchmarks::CurrentResidentBytes()
+{
+    return MemoryCounters().WorkingSetSize;
+}
+
+uint64_t Benchmarks::PeakResidentBytes()
+{
+    return MemoryCounters().PeakWorkingSetSize;
+}
+
+#elif defined(__linux__)
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    //
+    // Return a "Name: n kB" field from /proc/self/status in bytes.
+    //
+
+    uint64_t StatusField(const char * name)
+    {
+        std::FILE * status = std::fopen("/proc/self/status", "r");
+        if (status == nullptr)
+        {
+            return 0;
+        }
+
+        char line[256];
+        size_t length = std::strlen(name);
+        unsigned long long kilobytes = 0;
+
+        while (std::fgets(line, sizeof(line), status) != nullptr)
+        {
+            if ((std::strncmp(line, name, length) == 0) && (line[length] == ':'))
+            {
+                std::sscanf(line + length + 1, "%llu", &kilobytes);
+                break;
+            }
+        }
+
+        std::fclose(status);
+        return kilobytes * 1024;
+    }
+}
+
+uint64_t Benchmarks::CurrentResidentBytes()
+{
+    return StatusField("VmRSS");
+}
+
+uint64_t Benchmarks::PeakResidentBytes()
+{
+    return StatusField("VmHWM");
+}
+
+#else
+
+uint64_t Benchmarks::CurrentResidentBytes()
+{
+    return 0;
+}
+
+uint64_t Benchmarks::PeakResidentBytes()
+{
+    return 0;
+}
+
+#endif
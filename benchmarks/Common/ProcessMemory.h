@@ -0,0 +1,26 @@
+//
+// ProcessMemory.h
+//
+// Report the resident memory of the benchmark process.
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace Benchmarks
+{
+    //
+    // Return the bytes of memory resident in the process now, or 0 if the
+    // platform doesn't report it.
+    //
+
+    uint64_t CurrentResidentBytes();
+
+    //
+    // Return the most memory that has been resident in the process since it
+    // started, or 0 if the platform doesn't report it.
+    //
+
+    uint64_t PeakResidentBytes();
+}  // namespace Benchmarks
@@ -0,0 +1,113 @@
+//
+// ReferenceSplit.h
+//
+// A frozen copy of StringExtensionsT::Split as it behaved before any
+// tokenizer optimization.  Optimized splitters are checked against it by
+// SplitFuzz and compared with it by SplitBenchmark.  Do not change it to
+// follow Split; it defines the behavior Split must keep.
+//
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace Benchmarks
+{
+    //
+    // Split contents on any of the characters in separators.  A backslash
+    // copies the next character literally, and a double quote copies
+    // everything up to the matching quote (or the end) without treating
+    // separators as such.  An empty separator set returns the contents as
+    // one item.
+    //
+
+    inline std::vector<std::string> ReferenceSplit(const std::string & contents, const std::string & separators)
+    {
+        std::vector<std::string> results;
+
+        if (separators.empty())
+        {
+            results.push_back(contents);
+            return results;
+        }
+
+        std::string item;
+        auto it = contents.cbegin();
+
+        while (it != contents.cend())
+        {
+            if (*it == '\\')
+            {
+                if (++it != contents.cend())
+                {
+                    item.push_back(*it);
+                }
+            }
+            else if (separators.find_first_of(*it) != std::string::npos)
+            {
+                results.push_back(item);
+                item.clear();
+            }
+            else if (*it == '\"')
+            {
+                //
+                // Copy up to the closing quote, honoring backslashes, and
+                // leave the iterator on the quote or at the end.
+                //
+
+                ++it;
+                while ((it != contents.cend()) && (*it != '\"'))
+                {
+                    if ((*it == '\\') && (++it == contents.cend()))
+                    {
+                        break;
+                    }
+
+                    item.push_back(*it);
+                    ++it;
+                }
+            }
+            else
+            {
+                item.push_back(*it);
+            }
+
+            if (it != contents.cend())
+            {
+                ++it;
+            }
+        }
+
+        results.push_back(item);
+        return results;
+    }
+
+    //
+    // Split and drop the empty items, as Split(separators, true) does.
+    //
+
+    inline std::vector<std::string> ReferenceSplit(const std::string & contents,
+                                                   const std::string & separators,
+                                                   bool removeEmpty)
+    {
+        std::vector<std::string> results = ReferenceSplit(contents, separators);
+
+        if (removeEmpty)
+        {
+            std::vector<std::string> kept;
+
+            for (auto & item : results)
+            {
+                if (!item.empty())
+                {
+                    kept.push_back(std::move(item));
+                }
+            }
+
+            results.swap(kept);
+        }
+
+        return results;
+    }
+}  // namespace Benchmarks
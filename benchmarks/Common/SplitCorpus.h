@@ -0,0 +1,95 @@
+//
+// SplitCorpus.h
+//
+// Load a corpus of macro argument strings for the Split benchmark and fuzz
+// target.  Each line is label<TAB>delimiters<TAB>argument; lines starting
+// with # are comments.  See benchmarks/SplitBenchmark/SplitCorpus.txt.
+//
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace Benchmarks
+{
+    //
+    // One argument and the delimiters it is split on.
+    //
+
+    struct SplitCase
+    {
+        std::string Label;
+        std::string Separators;
+        std::string Contents;
+    };
+
+    struct SplitCorpus
+    {
+        std::vector<SplitCase> Cases;
+
+        //
+        // Read a corpus file.  On failure, return false and set error to
+        // the reason.
+        //
+
+        bool Load(const char * path, std::string & error)
+        {
+            std::FILE * file = std::fopen(path, "rb");
+
+            if (file == nullptr)
+            {
+                error = std::string("can't open ") + path;
+                return false;
+            }
+
+            std::string line;
+            size_t lineNumber = 0;
+            int c;
+
+            do
+            {
+                c = std::fgetc(file);
+
+                if ((c != '\n') && (c != EOF))
+                {
+                    line.push_back((char) c);
+                    continue;
+                }
+
+                ++lineNumber;
+
+                if (!line.empty() && (line.back() == '\r'))
+                {
+                    line.pop_back();
+                }
+
+                if (!line.empty() && (line[0] != '#'))
+                {
+                    size_t first = line.find('\t');
+                    size_t second = first == std::string::npos ? first : line.find('\t', first + 1);
+
+                    if (second == std::string::npos)
+                    {
+                        error = std::string(path) + ":" + std::to_string(lineNumber) + ": expected label<TAB>delimiters<TAB>argument";
+                        std::fclose(file);
+                        return false;
+                    }
+
+                    Cases.push_back(SplitCase
+                    {
+                        line.substr(0, first),
+                        line.substr(first + 1, second - first - 1),
+                        line.substr(second + 1)
+                    });
+                }
+
+                line.clear();
+            } while (c != EOF);
+
+            std::fclose(file);
+            return true;
+        }
+    };
+}  // namespace Benchmarks
@@ -0,0 +1,249 @@
+//
+// TraceReader.h
+//
+// Load a member call trace written by Diagnostics::TraceRecorder into
+// memory.  See plugin/TraceFormat.h for the layout.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "TraceFormat.h"
+
+namespace Benchmarks
+{
+    //
+    // One decoded trace record.  Fields that don't apply to the record's
+    // kind are left at their defaults.
+    //
+
+    struct TraceRecord
+    {
+        Diagnostics::TraceFormat::RecordKind Kind;
+        uint32_t Type = 0;
+        uint64_t Object = 0;
+        uint32_t Member = 0;
+        bool HasIndex = false;
+        bool Succeeded = false;
+        std::string Argument;
+        uint64_t ElapsedNanoseconds = 0;
+        Diagnostics::TraceFormat::ResultKind Result = Diagnostics::TraceFormat::ResultKind::None;
+        uint32_t ResultType = 0;
+        uint64_t ResultObject = 0;
+        int64_t ResultInteger = 0;
+        std::string ResultString;
+    };
+
+    //
+    // A trace loaded into memory.  Symbols[id] is the name defined by a
+    // Symbol record; Symbols[0] is empty.  Records holds every other record
+    // in the order it was written.
+    //
+
+    struct Trace
+    {
+        std::vector<std::string> Symbols;
+        std::vector<TraceRecord> Records;
+
+        //
+        // Read and decode a trace file.  On failure, return false and set
+        // error to the reason.
+        //
+
+        bool Load(const char * path, std::string & error)
+        {
+            using namespace Diagnostics::TraceFormat;
+
+            std::vector<uint8_t> contents;
+
+            if (!ReadFile(path, contents))
+            {
+                error = "can't read the trace file";
+                return false;
+            }
+
+            const uint8_t * cursor = contents.data();
+            const uint8_t * end = cursor + contents.size();
+
+            if ((contents.size() < sizeof(Magic) + 4)
+                || (std::memcmp(cursor, Magic, sizeof(Magic)) != 0))
+            {
+                error = "not a collections trace";
+                return false;
+            }
+
+            cursor += sizeof(Magic);
+
+            uint32_t version = cursor[0] | (cursor[1] << 8) | (cursor[2] << 16) | ((uint32_t) cursor[3] << 24);
+            if (version != Version)
+            {
+                error = "unsupported trace version " + std::to_string(version);
+                return false;
+            }
+
+            cursor += 4;
+
+            Symbols.assign(1, std::string());
+            Records.clear();
+
+            while (cursor < end)
+            {
+                TraceRecord record;
+
+                record.Kind = (RecordKind) *cursor++;
+                if (!DecodeRecord(cursor, end, record))
+                {
+                    error = "truncated or corrupt record at offset "
+                          + std::to_string(cursor - contents.data());
+                    return false;
+                }
+
+                if (record.Kind != RecordKind::Symbol)
+                {
+                    Records.push_back(std::move(record));
+                }
+            }
+
+            return true;
+        }
+
+    private:
+
+        //
+        // Read an entire file.
+        //
+
+        static bool ReadFile(const char * path, std::vector<uint8_t> & contents)
+        {
+            std::FILE * file = std::fopen(path, "rb");
+            if (file == nullptr)
+            {
+                return false;
+            }
+
+            uint8_t block[64 * 1024];
+            size_t count;
+
+            while ((count = std::fread(block, 1, sizeof(block), file)) != 0)
+            {
+                contents.insert(contents.end(), block, block + count);
+            }
+
+            std::fclose(file);
+            return true;
+        }
+
+        //
+        // Read a symbol id and check that it was defined.
+        //
+
+        bool GetSymbol(const uint8_t *& cursor, const uint8_t * end, uint32_t & symbol) const
+        {
+            uint64_t id;
+
+            if (!Diagnostics::TraceFormat::GetVarint(cursor, end, id) || (id >= Symbols.size()))
+            {
+                return false;
+            }
+
+            symbol = (uint32_t) id;
+            return true;
+        }
+
+        //
+        // Decode the body of a record whose kind has been read.
+        //
+
+        bool DecodeRecord(const uint8_t *& cursor, const uint8_t * end, TraceRecord & record)
+        {
+            using namespace Diagnostics::TraceFormat;
+
+            switch (record.Kind)
+            {
+                case RecordKind::Symbol:
+                {
+                    uint64_t id;
+                    std::string name;
+
+                    if (!GetVarint(cursor, end, id) || !GetString(cursor, end, name) || (id != Symbols.size()))
+                    {
+                        return false;
+                    }
+
+                    Symbols.push_back(std::move(name));
+                    return true;
+                }
+
+                case RecordKind::InitVariable:
+                case RecordKind::FreeVariable:
+                    return GetSymbol(cursor, end, record.Type)
+                        && GetVarint(cursor, end, record.Object);
+
+                case RecordKind::GetMember:
+                {
+                    if (!GetSymbol(cursor, end, record.Type)
+                        || !GetVarint(cursor, end, record.Object)
+                        || !GetSymbol(cursor, end, record.Member)
+                        || (cursor >= end))
+                    {
+                        return false;
+                    }
+
+                    uint8_t flags = *cursor++;
+
+                    record.HasIndex = (flags & HasIndex) != 0;
+                    record.Succeeded = (flags & Succeeded) != 0;
+
+                    if ((record.HasIndex && !GetString(cursor, end, record.Argument))
+                        || !GetVarint(cursor, end, record.ElapsedNanoseconds)
+                        || (cursor >= end))
+                    {
+                        return false;
+                    }
+
+                    record.Result = (ResultKind) *cursor++;
+
+                    switch (record.Result)
+                    {
+                        case ResultKind::None:
+                            return true;
+
+                        case ResultKind::Object:
+                            return GetSymbol(cursor, end, record.ResultType)
+                                && GetVarint(cursor, end, record.ResultObject);
+
+                        case ResultKind::String:
+                            return GetSymbol(cursor, end, record.ResultType)
+                                && GetString(cursor, end, record.ResultString);
+
+                        case ResultKind::Integer:
+                            return GetSymbol(cursor, end, record.ResultType)
+                                && GetSigned(cursor, end, record.ResultInteger);
+
+                        default:
+                            return false;
+                    }
+                }
+
+                case RecordKind::FromString:
+                    if (!GetSymbol(cursor, end, record.Type)
+                        || !GetVarint(cursor, end, record.Object)
+                        || (cursor >= end))
+                    {
+                        return false;
+                    }
+
+                    record.Succeeded = *cursor++ != 0;
+                    return GetString(cursor, end, record.Argument);
+
+                default:
+                    return false;
+            }
+        }
+    };
+}  // namespace Benchmarks
@@ -0,0 +1,661 @@
+//
+// ScalingBenchmark
+//
+// Build each collection type up to ten million items, with item lengths
+// drawn from realistic distributions, and report how much memory each
+// element costs and how the cost of the common members grows with the
+// size of the collection.
+//
+// For each type, distribution and size the Build row reports the time to
+// add one item through GetMember, the item text per element (payload), the
+// heap bytes in use per element, the growth in resident memory per element
+// and the peak resident memory of the process so far.  The rows that follow
+// report ns/op and allocs/op for members on the collection just built.
+//
+// Usage: ScalingBenchmark [--sizes 1000,...,10000000] [--budget-ms 200]
+//                         [--filter list/names] [--csv]
+//
+// The filter matches against "type/distribution.member".
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "AllocationAccounting.h"
+#include "BenchmarkSupport.h"
+#include "ProcessMemory.h"
+
+using namespace Benchmarks;
+
+namespace
+{
+    //
+    // A distribution of item lengths.
+    //
+
+    struct Distribution
+    {
+        const char * Name;
+        size_t MinimumLength;
+        size_t MaximumLength;
+
+        //
+        // When true, lengths cluster toward the short end, the way item and
+        // spawn names do; otherwise they are uniform.
+        //
+
+        bool Skewed;
+    };
+
+    const Distribution Distributions[] =
+    {
+        { "short", 6, 14, false },
+        { "names", 8, 48, true },
+        { "long", 40, 160, false },
+    };
+
+    //
+    // Mix the bits of a value (splitmix64), so items can be generated from
+    // their index without storing them.
+    //
+
+    uint64_t Mix(uint64_t value)
+    {
+        value += 0x9e3779b97f4a7c15ULL;
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+
+        return value ^ (value >> 31);
+    }
+
+    //
+    // Return the text of the n'th item for a distribution.  The text is
+    // words of letters ending in n in base 36, so every item is distinct
+    // and contains no delimiter, quote or escape characters.
+    //
+
+    std::string ItemText(const Distribution & distribution, size_t n)
+    {
+        static const char letters[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+        uint64_t random = Mix(n);
+        size_t span = distribution.MaximumLength - distribution.MinimumLength + 1;
+        size_t length;
+
+        if (distribution.Skewed)
+        {
+            //
+            // The smaller of two uniform draws favors short lengths.
+            //
+
+            length = distribution.MinimumLength
+                   + std::min<size_t>(random % span, (random >> 20) % span);
+        }
+        else
+        {
+            length = distribution.MinimumLength + random % span;
+        }
+
+        char suffix[16];
+        char * digits = suffix + sizeof(suffix);
+
+        do
+        {
+            *--digits = "0123456789abcdefghijklmnopqrstuvwxyz"[n % 36];
+            n /= 36;
+        } while (n != 0);
+
+        size_t suffixLength = suffix + sizeof(suffix) - digits;
+
+        std::string text;
+
+        text.reserve(length);
+        while (text.size() + suffixLength < length)
+        {
+            random = Mix(random);
+
+            if (!text.empty() && (random % 7 == 0) && (text.back() != ' '))
+            {
+                text.push_back(' ');
+            }
+            else
+            {
+                text.push_back(letters[random % (sizeof(letters) - 1)]);
+            }
+        }
+
+        text.append(digits, suffixLength);
+        return text;
+    }
+
+    //
+    // A member and the text used to add one item with it.
+    //
+
+    struct CollectionKind
+    {
+        const char * TypeName;
+        const char * AddMember;
+        bool KeyValue;
+    };
+
+    const CollectionKind Kinds[] =
+    {
+        { "list", "Append", false },
+        { "set", "Add", false },
+        { "map", "Add", true },
+        { "queue", "Push", false },
+        { "stack", "Push", false },
+    };
+
+    //
+    // Return the argument that adds the n'th item to a collection.
+    //
+
+    std::string AddArgument(const CollectionKind & kind, const Distribution & distribution, size_t n)
+    {
+        std::string item = ItemText(distribution, n);
+
+        return kind.KeyValue ? item + "," + item : item;
+    }
+
+    //
+    // Arguments naming items already in the collection, spread over it.
+    //
+
+    class ItemPool
+    {
+    public:
+
+        ItemPool(const Distribution & distribution, size_t elements, std::string (*format)(const Distribution &, size_t))
+        {
+            const size_t poolSize = 1024;
+
+            for (size_t i = 0; i < poolSize; ++i)
+            {
+                m_indexes.push_back((size_t) (Mix(i + 0x5eed) % elements));
+                m_arguments.emplace_back(format(distribution, m_indexes.back()));
+            }
+        }
+
+        char * Get(size_t n)
+        {
+            return m_arguments[n % m_arguments.size()].Get();
+        }
+
+        size_t ItemIndex(size_t n) const
+        {
+            return m_indexes[n % m_indexes.size()];
+        }
+
+    private:
+
+        std::vector<Argument> m_arguments;
+        std::vector<size_t> m_indexes;
+    };
+
+    std::string PositionText(const Distribution &, size_t n)
+    {
+        return std::to_string(n);
+    }
+
+    //
+    // Print the header for the report.
+    //
+
+    void PrintHeader(const Options & options)
+    {
+        if (options.Csv)
+        {
+            std::printf("name,member,elements,ns_per_op,allocs_per_op,payload_bytes,heap_bytes,rss_bytes,peak_rss_mb\n");
+        }
+        else
+        {
+            std::printf("%-14s %-15s %10s %12s %10s %9s %9s %9s %11s\n",
+                        "collection", "member", "elements", "ns/op", "allocs/op",
+                        "payload", "heap/el", "rss/el", "peak MB");
+        }
+    }
+
+    //
+    // Print a row for a member measurement.
+    //
+
+    void PrintMember(const Options & options, const std::string & name, const char * member, size_t elements, const Measurement & result)
+    {
+        std::printf(options.Csv ? "%s,%s,%zu,%.1f,%.2f,,,,\n" : "%-14s %-15s %10zu %12.1f %10.2f\n",
+                    name.c_str(),
+                    member,
+                    elements,
+                    result.NanosecondsPerOp,
+                    result.AllocationsPerOp);
+        std::fflush(stdout);
+    }
+
+    //
+    // Print the footprint of a collection.
+    //
+
+    void PrintBuild(const Options & options,
+                    const std::string & name,
+                    size_t elements,
+                    const Measurement & build,
+                    double payload,
+                    double heap,
+                    double rss,
+                    uint64_t peak)
+    {
+        std::printf(options.Csv ? "%s,%s,%zu,%.1f,%.2f,%.1f,%.1f,%.1f,%.1f\n"
+                                : "%-14s %-15s %10zu %12.1f %10.2f %9.1f %9.1f %9.1f %11.1f\n",
+                    name.c_str(),
+                    "Build",
+                    elements,
+                    build.NanosecondsPerOp,
+                    build.AllocationsPerOp,
+                    payload,
+                    heap,
+                    rss,
+                    peak / (1024.0 * 1024.0));
+        std::fflush(stdout);
+    }
+
+    //
+    // Measure the members worth tracking on a collection of elements items.
+    // Members that add items run last, since they grow the collection.
+    //
+
+    class Scaling
+    {
+    public:
+
+        Scaling(const Options & options, const CollectionKind & kind, const Distribution & distribution)
+            : m_options(options),
+              m_kind(kind),
+              m_distribution(distribution),
+              m_name(std::string(kind.TypeName) + "/" + distribution.Name)
+        {
+        }
+
+        //
+        // Return true if any row for this collection and distribution
+        // passes the filter.
+        //
+
+        bool Selected() const
+        {
+            static const char * members[] =
+            {
+                "Build", "Item", "ItemInOrder", "Contains", "IndexedContains", "IndexedIndex",
+                "Remove", "Sort", "SplitAppend", "SplitAdd", "Peek", "PopPush"
+            };
+
+            for (const char * member : members)
+            {
+                if (Selected(member))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        void Run(size_t elements)
+        {
+            MQTypeVar collection = Declare(m_kind.TypeName);
+
+            Build(collection, elements);
+
+            if (std::string(m_kind.TypeName) == "list")
+            {
+                ListMembers(collection, elements);
+            }
+            else if (m_kind.KeyValue || (std::string(m_kind.TypeName) == "set"))
+            {
+                AssociativeMembers(collection, elements);
+            }
+            else
+            {
+                SequenceMembers(collection, elements);
+            }
+
+            Release(collection);
+        }
+
+    private:
+
+        bool Selected(const char * member) const
+        {
+            return m_options.Selected(m_name + "." + member);
+        }
+
+        //
+        // Add items one GetMember call at a time and report the footprint.
+        //
+
+        void Build(MQTypeVar & collection, size_t elements)
+        {
+            uint64_t liveBefore = Diagnostics::AllocationAccounting::LiveBytes();
+            uint64_t residentBefore = CurrentResidentBytes();
+            uint64_t payload = 0;
+            std::vector<char> argument;
+
+            Measurement build = MeasureAll(elements, [&](size_t n)
+            {
+                std::string text = AddArgument(m_kind, m_distribution, n);
+
+                payload += m_kind.KeyValue ? text.size() - 1 : text.size();
+                argument.assign(text.begin(), text.end());
+                argument.push_back('\0');
+
+                return argument.data();
+            }, collection, m_kind.AddMember);
+
+            uint64_t liveAfter = Diagnostics::AllocationAccounting::LiveBytes();
+            uint64_t residentAfter = CurrentResidentBytes();
+
+            if (Selected("Build"))
+            {
+                PrintBuild(m_options,
+                           m_name,
+                           elements,
+                           build,
+                           (double) payload / elements,
+                           (double) (int64_t) (liveAfter - liveBefore) / elements,
+                           (double) (int64_t) (residentAfter - residentBefore) / elements,
+                           PeakResidentBytes());
+            }
+        }
+
+        //
+        // Call a member once for each of count generated arguments, timing
+        // only the member calls.
+        //
+
+        template<typename ArgumentFor>
+        Measurement MeasureAll(size_t count, ArgumentFor argumentFor, MQTypeVar & collection, const char * member)
+        {
+            using clock = std::chrono::steady_clock;
+
+            clock::duration elapsed(0);
+            uint64_t allocations = 0;
+
+            for (size_t n = 0; n < count; ++n)
+            {
+                char * argument = argumentFor(n);
+
+                AllocationCount before = CurrentAllocations();
+                auto start = clock::now();
+
+                Invoke(collection, member, argument);
+
+                elapsed += clock::now() - start;
+                allocations += CurrentAllocations().Allocations - before.Allocations;
+            }
+
+            return Measurement
+            {
+                count,
+                (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / count,
+                (double) allocations / count,
+                0.0
+            };
+        }
+
+        //
+        // Return the argument that adds eight new items with one call.
+        //
+
+        std::string SplitArgument(size_t first)
+        {
+            std::string text;
+
+            for (size_t i = 0; i < 8; ++i)
+            {
+                if (i != 0)
+                {
+                    text.push_back(',');
+                }
+
+                text += AddArgument(m_kind, m_distribution, first + i);
+            }
+
+            return text;
+        }
+
+        void ListMembers(MQTypeVar & list, size_t elements)
+        {
+            ItemPool positions(m_distribution, elements, PositionText);
+            ItemPool items(m_distribution, elements, ItemText);
+
+            if (Selected("Item"))
+            {
+                PrintMember(m_options, m_name, "Item", elements, Measure([&](size_t n)
+                {
+                    Invoke(list, "Item", positions.Get(n));
+                }, m_options.Budget));
+            }
+
+            //
+            // Index every item in turn, as a macro looping over the list
+            // does.
+            //
+
+            if (Selected("ItemInOrder"))
+            {
+                char position[32];
+
+                PrintMember(m_options, m_name, "ItemInOrder", elements, Measure([&](size_t n)
+                {
+                    snprintf(position, sizeof(position), "%zu", n % elements);
+                    Invoke(list, "Item", position);
+                }, m_options.Budget));
+            }
+
+            if (Selected("Contains"))
+            {
+                PrintMember(m_options, m_name, "Contains", elements, Measure([&](size_t n)
+                {
+                    Invoke(list, "Contains", items.Get(n));
+                }, m_options.Budget));
+            }
+
+            //
+            // The same lookups once the list keeps an index of its values.
+            //
+
+            if (Selected("IndexedContains") || Selected("IndexedIndex"))
+            {
+                Argument on("TRUE");
+                Argument off("FALSE");
+
+                Invoke(list, "Indexed", on.Get());
+
+                if (Selected("IndexedContains"))
+                {
+                    PrintMember(m_options, m_name, "IndexedContains", elements, Measure([&](size_t n)
+                    {
+                        Invoke(list, "Contains", items.Get(n));
+                    }, m_options.Budget));
+                }
+
+                if (Selected("IndexedIndex"))
+                {
+                    PrintMember(m_options, m_name, "IndexedIndex", elements, Measure([&](size_t n)
+                    {
+                        Invoke(list, "Index", items.Get(n));
+                    }, m_options.Budget));
+                }
+
+                Invoke(list, "Indexed", off.Get());
+            }
+
+            if (Selected("Remove"))
+            {
+                PrintMember(m_options, m_name, "Remove", elements, MeasureEach([&](size_t n)
+                {
+                    Invoke(list, "Remove", items.Get(n));
+                },
+                [&](size_t n)
+                {
+                    Invoke(list, "Append", items.Get(n));
+                }, m_options.Budget));
+            }
+
+            if (Selected("Sort"))
+            {
+                PrintMember(m_options, m_name, "Sort", elements, Measure([&](size_t)
+                {
+                    Invoke(list, "Sort");
+                }, m_options.Budget, 1));
+            }
+
+            SplitAdd(list, "SplitAppend", elements);
+        }
+
+        void AssociativeMembers(MQTypeVar & collection, size_t elements)
+        {
+            ItemPool keys(m_distribution, elements, ItemText);
+            std::vector<Argument> adds;
+
+            for (size_t i = 0; i < 1024; ++i)
+            {
+                adds.emplace_back(AddArgument(m_kind, m_distribution, keys.ItemIndex(i)));
+            }
+
+            if (Selected("Contains"))
+            {
+                PrintMember(m_options, m_name, "Contains", elements, Measure([&](size_t n)
+                {
+                    Invoke(collection, "Contains", keys.Get(n));
+                }, m_options.Budget));
+            }
+
+            if (Selected("Remove"))
+            {
+                PrintMember(m_options, m_name, "Remove", elements, MeasureEach([&](size_t n)
+                {
+                    Invoke(collection, "Remove", keys.Get(n));
+                },
+                [&](size_t n)
+                {
+                    Invoke(collection, "Add", adds[n % adds.size()].Get());
+                }, m_options.Budget));
+            }
+
+            SplitAdd(collection, "SplitAdd", elements);
+        }
+
+        void SequenceMembers(MQTypeVar & collection, size_t elements)
+        {
+            if (Selected("Peek"))
+            {
+                PrintMember(m_options, m_name, "Peek", elements, Measure([&](size_t)
+                {
+                    Invoke(collection, "Peek");
+                }, m_options.Budget));
+            }
+
+            if (Selected("PopPush"))
+            {
+                Argument item(ItemText(m_distribution, 0));
+
+                PrintMember(m_options, m_name, "PopPush", elements, Measure([&](size_t)
+                {
+                    Invoke(collection, "Pop");
+                    Invoke(collection, "Push", item.Get());
+                }, m_options.Budget));
+            }
+        }
+
+        //
+        // Add eight new items per call, splitting the argument on commas.
+        // Maps split on commas into key,value pairs, so they aren't
+        // measured this way.  The collection grows by at most an eighth of
+        // its size plus 8K items.
+        //
+
+        void SplitAdd(MQTypeVar & collection, const char * member, size_t elements)
+        {
+            if (m_kind.KeyValue || !Selected(member))
+            {
+                return;
+            }
+
+            std::vector<Argument> arguments;
+            for (size_t i = 0; i < 1024; ++i)
+            {
+                arguments.emplace_back(SplitArgument(elements + i * 8));
+            }
+
+            Measurement result = Measure([&](size_t n)
+            {
+                //
+                // After the first pass the items already exist; sets then
+                // measure the duplicate path, lists keep appending.
+                //
+
+                Invoke(collection, m_kind.AddMember, arguments[n % arguments.size()].Get());
+            }, m_options.Budget, std::max<size_t>(1024, elements / 64));
+
+            result.NanosecondsPerOp /= 8;
+            result.AllocationsPerOp /= 8;
+
+            PrintMember(m_options, m_name, member, elements, result);
+        }
+
+        const Options & m_options;
+        const CollectionKind & m_kind;
+        const Distribution & m_distribution;
+        std::string m_name;
+    };
+}
+
+int main(int argc, char ** argv)
+{
+    Options options;
+
+    options.Sizes = { 1000, 10000, 100000, 1000000, 10000000 };
+
+    if (!options.Parse(argc, argv))
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--sizes 1000,...,10000000] [--budget-ms n] "
+                     "[--filter list/names.Item] [--csv]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    RegisterTypes();
+
+    if (Diagnostics::AllocationAccounting::LiveBytes() == 0)
+    {
+        std::fprintf(stderr, "Heap bytes in use aren't tracked on this platform; heap/el is 0.\n");
+    }
+
+    PrintHeader(options);
+
+    for (const auto & kind : Kinds)
+    {
+        for (const auto & distribution : Distributions)
+        {
+            Scaling scaling(options, kind, distribution);
+
+            if (!scaling.Selected())
+            {
+                continue;
+            }
+
+            for (size_t elements : options.Sizes)
+            {
+                scaling.Run(elements);
+            }
+        }
+    }
+
+    UnregisterTypes();
+    return 0;
+}
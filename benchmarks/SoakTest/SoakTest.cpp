@@ -0,0 +1,637 @@
+//
+// SoakTest
+//
+// Drive the collection types with a long random mix of the operations a
+// macro session makes -- /declare and /deletevar of collections, Find,
+// Clone, Splice and /vardata of the objects they return -- and check that
+// the number of live objects, the heap in use and the resident memory stay
+// flat.  Clients run for days, so a leak of one object every few thousand
+// operations matters.
+//
+// Variables are kept in a fixed number of slots.  A checkpoint row is
+// printed every --check-every operations.  At the end every slot is freed
+// and the test fails if any object or more than a few KB of heap is still
+// alive, or if resident memory grew by more than --max-growth-mb after the
+// first checkpoint.
+//
+// Usage: SoakTest [--operations n] [--seed n] [--slots n]
+//                 [--check-every n] [--max-growth-mb n]
+//
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "AllocationAccounting.h"
+#include "ArgumentCache.h"
+#include "BenchmarkSupport.h"
+#include "ProcessMemory.h"
+
+#include "List.h"
+#include "Map.h"
+#include "Queue.h"
+#include "Set.h"
+#include "Stack.h"
+
+using namespace Benchmarks;
+using namespace Collections::Containers;
+
+namespace
+{
+    //
+    // Options for the soak test.
+    //
+
+    struct SoakOptions
+    {
+        uint64_t Operations = 100000000;
+        uint64_t Seed = 1;
+        size_t Slots = 64;
+        uint64_t CheckEvery = 1000000;
+        uint64_t MaxGrowthMegabytes = 16;
+
+        //
+        // Parse the command line.  Return false if the arguments are not
+        // understood.
+        //
+
+        bool Parse(int argc, char ** argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                std::string arg(argv[i]);
+
+                if (i + 1 >= argc)
+                {
+                    return false;
+                }
+
+                uint64_t value = std::strtoull(argv[++i], nullptr, 10);
+
+                if (arg == "--operations")
+                {
+                    Operations = value;
+                }
+                else if (arg == "--seed")
+                {
+                    Seed = value;
+                }
+                else if ((arg == "--slots") && (value != 0))
+                {
+                    Slots = (size_t) value;
+                }
+                else if ((arg == "--check-every") && (value != 0))
+                {
+                    CheckEvery = value;
+                }
+                else if (arg == "--max-growth-mb")
+                {
+                    MaxGrowthMegabytes = value;
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    };
+
+    //
+    // Largest collection the test builds before clearing it.
+    //
+
+    const int MaximumElements = 256;
+
+    //
+    // Collection types a slot can be declared as, and the iterator type
+    // their Find and First members return.
+    //
+
+    struct CollectionKind
+    {
+        const char * TypeName;
+        const char * IteratorTypeName;
+    };
+
+    const CollectionKind Kinds[] =
+    {
+        { "list", "listiterator" },
+        { "set", "setiterator" },
+        { "map", "mapiterator" },
+        { "queue", nullptr },
+        { "stack", nullptr },
+    };
+
+    //
+    // Number of objects of each collection and iterator type alive.
+    //
+
+    struct LiveCount
+    {
+        const char * TypeName;
+        size_t (*Count)();
+    };
+
+    const LiveCount LiveCounts[] =
+    {
+        { "list", List::LiveInstances },
+        { "listiterator", ListIterator::LiveInstances },
+        { "set", Set::LiveInstances },
+        { "setiterator", SetIterator::LiveInstances },
+        { "map", Map::LiveInstances },
+        { "mapiterator", MapIterator::LiveInstances },
+        { "queue", Queue::LiveInstances },
+        { "stack", Stack::LiveInstances },
+    };
+
+    std::vector<size_t> LiveObjectsByType()
+    {
+        std::vector<size_t> result;
+
+        for (const auto & count : LiveCounts)
+        {
+            result.push_back(count.Count());
+        }
+
+        return result;
+    }
+
+    size_t LiveObjects()
+    {
+        size_t total = 0;
+
+        for (size_t count : LiveObjectsByType())
+        {
+            total += count;
+        }
+
+        return total;
+    }
+
+    //
+    // A variable as a macro declares it.  Type is null when the slot is
+    // free.
+    //
+
+    struct Slot
+    {
+        MQTypeVar Variable {};
+        const CollectionKind * Kind = nullptr;
+    };
+
+    class Soak
+    {
+    public:
+
+        Soak(const SoakOptions & options)
+            : m_slots(options.Slots),
+              m_random(options.Seed)
+        {
+            for (size_t i = 0; i < 512; ++i)
+            {
+                m_words.emplace_back("item" + std::to_string(i));
+                m_pairs.emplace_back("key" + std::to_string(i) + ",value" + std::to_string(i));
+            }
+
+            for (size_t i = 0; i < 256; ++i)
+            {
+                std::string text = "item" + std::to_string(Next(m_words.size()));
+
+                for (size_t count = Next(8); count != 0; --count)
+                {
+                    text += ",item" + std::to_string(Next(m_words.size()));
+                }
+
+                m_lists.emplace_back(text);
+            }
+
+            for (size_t i = 0; i < 64; ++i)
+            {
+                m_splices.emplace_back(std::to_string(Next(MaximumElements)) + "," + std::to_string(Next(16)));
+            }
+        }
+
+        //
+        // Make one randomly chosen operation on a randomly chosen slot.
+        //
+
+        void Step()
+        {
+            Slot & slot = m_slots[Next(m_slots.size())];
+            size_t operation = Next(100);
+
+            if ((slot.Variable.Type == nullptr) || (operation < 4))
+            {
+                Declare(slot);
+            }
+            else if (operation < 8)
+            {
+                Free(slot);
+            }
+            else if (slot.Kind == nullptr)
+            {
+                //
+                // The slot holds a cloned iterator.  Its collection may have
+                // changed since, so the only safe thing to do is replace it.
+                //
+
+                Free(slot);
+            }
+            else if (operation < 40)
+            {
+                Fill(slot);
+            }
+            else if (operation < 55)
+            {
+                Find(slot);
+            }
+            else if (operation < 80)
+            {
+                Clone(slot);
+            }
+            else if (operation < 92)
+            {
+                Splice(slot);
+            }
+            else if ((operation < 96) && (std::string(slot.Kind->TypeName) == "list"))
+            {
+                Invoke(slot.Variable, "RemoveAll", m_lists[Next(m_lists.size())].Get());
+            }
+            else
+            {
+                Invoke(slot.Variable, "Remove", m_words[Next(m_words.size())].Get());
+            }
+        }
+
+        //
+        // Free every slot, as ending the macro does.
+        //
+
+        void FreeAll()
+        {
+            for (auto & slot : m_slots)
+            {
+                Free(slot);
+            }
+        }
+
+    private:
+
+        size_t Next(size_t bound)
+        {
+            return (size_t) (m_random() % bound);
+        }
+
+        //
+        // /deletevar.
+        //
+
+        void Free(Slot & slot)
+        {
+            if (slot.Variable.Type != nullptr)
+            {
+                slot.Variable.Type->FreeVariable(slot.Variable);
+                slot.Variable.Type = nullptr;
+                slot.Kind = nullptr;
+            }
+        }
+
+        //
+        // /declare a new collection, replacing the variable in the slot.
+        //
+
+        void Declare(Slot & slot)
+        {
+            Free(slot);
+
+            slot.Kind = &Kinds[Next(sizeof(Kinds) / sizeof(Kinds[0]))];
+            slot.Variable = Benchmarks::Declare(slot.Kind->TypeName);
+
+            //
+            // Index half of the lists, so that each change also updates and
+            // frees index entries.
+            //
+
+            if ((std::string(slot.Kind->TypeName) == "list") && (Next(2) == 0))
+            {
+                Argument indexed("TRUE");
+
+                Invoke(slot.Variable, "Indexed", indexed.Get());
+            }
+        }
+
+        //
+        // Add items, clearing the collection once it is large.
+        //
+
+        void Fill(Slot & slot)
+        {
+            const std::string type(slot.Kind->TypeName);
+
+            if (Invoke(slot.Variable, "Count").Int > MaximumElements)
+            {
+                if ((type == "queue") || (type == "stack"))
+                {
+                    Invoke(slot.Variable, "Pop");
+                }
+                else
+                {
+                    Invoke(slot.Variable, "Clear");
+                }
+            }
+            else if (type == "list")
+            {
+                Invoke(slot.Variable, "Append", m_lists[Next(m_lists.size())].Get());
+            }
+            else if (type == "set")
+            {
+                Invoke(slot.Variable, "Add", m_lists[Next(m_lists.size())].Get());
+            }
+            else if (type == "map")
+            {
+                Invoke(slot.Variable, "Add", m_pairs[Next(m_pairs.size())].Get());
+            }
+            else
+            {
+                Invoke(slot.Variable, "Push", m_words[Next(m_words.size())].Get());
+            }
+        }
+
+        //
+        // Return an iterator from First or Find.  The collection holds it.
+        //
+
+        MQTypeVar Iterator(Slot & slot)
+        {
+            if (Next(2) == 0)
+            {
+                return Invoke(slot.Variable, "First");
+            }
+
+            char * key = std::string(slot.Kind->TypeName) == "map"
+                ? m_pairs[Next(m_pairs.size())].Get()
+                : m_words[Next(m_words.size())].Get();
+
+            //
+            // Keys are "keyN,valueN"; look up the key part.
+            //
+
+            std::string text(key);
+            Argument argument(text.substr(0, text.find(',')));
+
+            return Invoke(slot.Variable, "Find", argument.Get());
+        }
+
+        //
+        // Find an item and walk from it.
+        //
+
+        void Find(Slot & slot)
+        {
+            if (slot.Kind->IteratorTypeName == nullptr)
+            {
+                Invoke(slot.Variable, "Peek");
+                return;
+            }
+
+            MQTypeVar iterator = Iterator(slot);
+
+            if (iterator.Type != nullptr)
+            {
+                for (size_t steps = Next(4); (steps != 0) && (Invoke(iterator, "IsEnd").Int == 0); --steps)
+                {
+                    Invoke(iterator, "Value");
+                    Invoke(iterator, "Advance");
+                }
+            }
+        }
+
+        //
+        // Keep an iterator in another slot, as /vardata it ${c.First} does,
+        // or clone it first, as /vardata it ${c.Find[x].Clone} does.
+        //
+
+        void Clone(Slot & slot)
+        {
+            if (slot.Kind->IteratorTypeName == nullptr)
+            {
+                return;
+            }
+
+            MQTypeVar iterator = Iterator(slot);
+            if (iterator.Type == nullptr)
+            {
+                return;
+            }
+
+            if (Next(2) == 0)
+            {
+                //
+                // A variable can't be redeclared while its own iterator is
+                // being assigned, so leave the collection's slot alone.
+                //
+
+                Slot & target = m_slots[Next(m_slots.size())];
+                if (&target != &slot)
+                {
+                    Assign(target, iterator, slot.Kind->IteratorTypeName);
+                }
+
+                return;
+            }
+
+            MQTypeVar clone = Invoke(iterator, "Clone");
+            if (clone.Type == nullptr)
+            {
+                return;
+            }
+
+            Invoke(clone, "Advance");
+            Assign(m_slots[Next(m_slots.size())], clone, slot.Kind->IteratorTypeName);
+        }
+
+        //
+        // Splice a list and keep the new list in another slot, as
+        // /vardata l2 ${l.Splice[a,b]} does.
+        //
+
+        void Splice(Slot & slot)
+        {
+            if (std::string(slot.Kind->TypeName) != "list")
+            {
+                return;
+            }
+
+            MQTypeVar splice = Invoke(slot.Variable, "Splice", m_splices[Next(m_splices.size())].Get());
+            if (splice.Type != nullptr)
+            {
+                Assign(m_slots[Next(m_slots.size())], splice, "list");
+            }
+        }
+
+        //
+        // /vardata an object into a slot, declaring the slot as the object's
+        // type first if it holds something else.  The variable takes
+        // ownership of the object.
+        //
+
+        void Assign(Slot & target, MQTypeVar & object, const char * typeName)
+        {
+            MQ2Type * type = Types::TypeMap::GetTypeInstanceForTypeName(typeName);
+
+            if (target.Variable.Type != type)
+            {
+                Free(target);
+
+                target.Variable.Type = type;
+                type->InitVariable(target.Variable);
+            }
+
+            target.Variable.Type->FromData(target.Variable, object);
+
+            //
+            // Only a list is a collection; a slot holding an iterator only
+            // gets replaced.
+            //
+
+            target.Kind = std::string(typeName) == "list" ? &Kinds[0] : nullptr;
+        }
+
+        std::vector<Slot> m_slots;
+        std::vector<Argument> m_words;
+        std::vector<Argument> m_pairs;
+        std::vector<Argument> m_lists;
+        std::vector<Argument> m_splices;
+        std::mt19937_64 m_random;
+    };
+
+    void PrintCheckpoint(uint64_t operations, size_t objects, uint64_t liveBytes, uint64_t resident)
+    {
+        std::printf("%14llu %10zu %12.1f %12.1f\n",
+                    (unsigned long long) operations,
+                    objects,
+                    liveBytes / 1024.0,
+                    resident / (1024.0 * 1024.0));
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    SoakOptions options;
+
+    if (!options.Parse(argc, argv))
+    {
+        std::fprintf(stderr,
+                     "usage: %s [--operations n] [--seed n] [--slots n] [--check-every n] [--max-growth-mb n]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    RegisterTypes();
+
+    std::vector<size_t> baseByType = LiveObjectsByType();
+    size_t baseObjects = LiveObjects();
+    uint64_t baseBytes = Diagnostics::AllocationAccounting::LiveBytes();
+    uint64_t firstResident = 0;
+    uint64_t lastResident = 0;
+
+    std::printf("%14s %10s %12s %12s\n", "operations", "objects", "heap KB", "rss MB");
+
+    {
+        Soak soak(options);
+
+        for (uint64_t operation = 1; operation <= options.Operations; ++operation)
+        {
+            soak.Step();
+
+            if ((operation % options.CheckEvery == 0) || (operation == options.Operations))
+            {
+                lastResident = CurrentResidentBytes();
+                if (firstResident == 0)
+                {
+                    firstResident = lastResident;
+                }
+
+                PrintCheckpoint(operation,
+                                LiveObjects() - baseObjects,
+                                Diagnostics::AllocationAccounting::LiveBytes() - baseBytes,
+                                lastResident);
+            }
+        }
+
+        soak.FreeAll();
+    }
+
+    //
+    // Return the storage kept for recycling iterators to the heap.
+    //
+
+    Utilities::Pools::ObjectPool<ListIterator>::Trim();
+    Utilities::Pools::ObjectPool<SetIterator>::Trim();
+    Utilities::Pools::ObjectPool<MapIterator>::Trim();
+
+    //
+    // And the split arguments remembered by the argument cache.
+    //
+
+    Collections::ArgumentCache::Clear();
+
+    //
+    // Everything the test made is gone; only heap kept by the containers'
+    // static state may remain.
+    //
+
+    const int64_t HeapSlack = 16 * 1024;
+
+    size_t leakedObjects = LiveObjects() - baseObjects;
+    int64_t leakedBytes = (int64_t) (Diagnostics::AllocationAccounting::LiveBytes() - baseBytes);
+    int64_t growth = (int64_t) (lastResident - firstResident);
+    bool failed = false;
+
+    std::printf("after freeing every variable: %zu objects and %lld heap bytes remain\n",
+                leakedObjects,
+                (long long) leakedBytes);
+
+    if (leakedObjects != 0)
+    {
+        std::vector<size_t> byType = LiveObjectsByType();
+
+        std::printf("FAILED: %zu objects leaked\n", leakedObjects);
+        for (size_t i = 0; i < byType.size(); ++i)
+        {
+            if (byType[i] != baseByType[i])
+            {
+                std::printf("    %-14s %zu\n", LiveCounts[i].TypeName, byType[i] - baseByType[i]);
+            }
+        }
+
+        failed = true;
+    }
+
+    if (leakedBytes > HeapSlack)
+    {
+        std::printf("FAILED: %lld heap bytes leaked\n", (long long) leakedBytes);
+        failed = true;
+    }
+
+    if (growth > (int64_t) (options.MaxGrowthMegabytes * 1024 * 1024))
+    {
+        std::printf("FAILED: resident memory grew %.1f MB after the first checkpoint\n",
+                    growth / (1024.0 * 1024.0));
+        failed = true;
+    }
+
+    UnregisterTypes();
+
+    if (!failed)
+    {
+        std::printf("passed\n");
+    }
+
+    return failed ? 1 : 0;
+}
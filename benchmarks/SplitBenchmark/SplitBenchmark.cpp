@@ -0,0 +1,248 @@
+//
+// SplitBenchmark
+//
+// Measure StringExtensions::Split on a corpus of real macro argument
+// strings -- plain item lists, map key/value pairs, quoted items, backslash
+// escapes and multi-character delimiter sets -- and compare it with the
+// reference splitter it must stay equivalent to.
+//
+// For each corpus label, and for the whole corpus, report the bytes and
+// items per argument, ns/split for Split and for the reference, Split's
+// throughput and allocations/split, and ns/split and allocations/split for
+// SplitItems, which splits into views.  Every argument is checked against the
+// reference before it is timed.
+//
+// Usage: SplitBenchmark [--corpus SplitCorpus.txt] [--budget-ms 200]
+//                       [--filter label] [--csv]
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "ReferenceSplit.h"
+#include "SplitCorpus.h"
+#include "StringExtensions.h"
+
+using namespace Benchmarks;
+using Extensions::Strings::SplitItems;
+using Extensions::Strings::StringExtensions;
+
+namespace
+{
+    //
+    // The arguments under one label, ready to split.
+    //
+
+    struct Group
+    {
+        std::string Label;
+        std::vector<const SplitCase *> Cases;
+        std::vector<std::unique_ptr<StringExtensions>> Arguments;
+        size_t Bytes = 0;
+        size_t Items = 0;
+    };
+
+    //
+    // Return true if Split and the reference agree on a case, printing the
+    // case if they don't.
+    //
+
+    bool Agrees(const SplitCase & split)
+    {
+        auto actual = StringExtensions(split.Contents).Split(split.Separators);
+        auto expected = ReferenceSplit(split.Contents, split.Separators);
+
+        if (*actual == expected)
+        {
+            return true;
+        }
+
+        std::fprintf(stderr,
+                     "Split differs from the reference on [%s] split on [%s]: %zu items, expected %zu.\n",
+                     split.Contents.c_str(),
+                     split.Separators.c_str(),
+                     actual->size(),
+                     expected.size());
+        return false;
+    }
+
+    void AddCase(Group & group, const SplitCase & split)
+    {
+        group.Cases.push_back(&split);
+        group.Arguments.push_back(std::make_unique<StringExtensions>(split.Contents));
+        group.Bytes += split.Contents.size();
+        group.Items += ReferenceSplit(split.Contents, split.Separators).size();
+    }
+
+    void ReportHeader(bool csv)
+    {
+        if (csv)
+        {
+            std::printf("label,arguments,bytes_per_split,items_per_split,ns_per_split,reference_ns_per_split,mb_per_second,allocs_per_split,view_ns_per_split,view_allocs_per_split\n");
+        }
+        else
+        {
+            std::printf("%-10s %9s %9s %9s %12s %12s %9s %10s %13s %11s\n",
+                        "label", "arguments", "bytes", "items", "ns/split", "ref ns/split", "MB/s", "allocs", "view ns/split", "view allocs");
+        }
+    }
+
+    //
+    // Time Split, SplitItems and the reference over every argument in a
+    // group.
+    //
+
+    void Run(const Group & group, std::chrono::milliseconds budget, bool csv)
+    {
+        const size_t count = group.Cases.size();
+
+        Measurement split = Measure([&](size_t n)
+        {
+            const size_t i = n % count;
+
+            group.Arguments[i]->Split(group.Cases[i]->Separators);
+        }, budget);
+
+        SplitItems items;
+
+        Measurement views = Measure([&](size_t n)
+        {
+            const SplitCase & split = *group.Cases[n % count];
+
+            items.Split(split.Contents, split.Separators);
+        }, budget);
+
+        Measurement reference = Measure([&](size_t n)
+        {
+            const SplitCase & split = *group.Cases[n % count];
+
+            ReferenceSplit(split.Contents, split.Separators);
+        }, budget);
+
+        double bytes = (double) group.Bytes / count;
+
+        std::printf(csv ? "%s,%zu,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f,%.1f,%.2f\n"
+                        : "%-10s %9zu %9.1f %9.1f %12.1f %12.1f %9.1f %10.2f %13.1f %11.2f\n",
+                    group.Label.c_str(),
+                    count,
+                    bytes,
+                    (double) group.Items / count,
+                    split.NanosecondsPerOp,
+                    reference.NanosecondsPerOp,
+                    bytes * 1000.0 / split.NanosecondsPerOp,
+                    split.AllocationsPerOp,
+                    views.NanosecondsPerOp,
+                    views.AllocationsPerOp);
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    std::string corpusPath = "SplitCorpus.txt";
+    std::chrono::milliseconds budget(200);
+    std::string filter;
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+
+        if ((arg == "--corpus") && (i + 1 < argc))
+        {
+            corpusPath = argv[++i];
+        }
+        else if ((arg == "--budget-ms") && (i + 1 < argc))
+        {
+            budget = std::chrono::milliseconds(std::atoi(argv[++i]));
+        }
+        else if ((arg == "--filter") && (i + 1 < argc))
+        {
+            filter = argv[++i];
+        }
+        else if (arg == "--csv")
+        {
+            csv = true;
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--corpus SplitCorpus.txt] [--budget-ms n] [--filter label] [--csv]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    SplitCorpus corpus;
+    std::string error;
+
+    if (!corpus.Load(corpusPath.c_str(), error))
+    {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    bool agrees = true;
+
+    for (const auto & split : corpus.Cases)
+    {
+        agrees = Agrees(split) && agrees;
+    }
+
+    if (!agrees)
+    {
+        return 1;
+    }
+
+    //
+    // Group the arguments by label, keeping the corpus order.
+    //
+
+    std::vector<Group> groups;
+    std::map<std::string, size_t> groupIndexes;
+    Group all;
+
+    all.Label = "all";
+
+    for (const auto & split : corpus.Cases)
+    {
+        if (!filter.empty() && (split.Label.find(filter) == std::string::npos))
+        {
+            continue;
+        }
+
+        auto found = groupIndexes.find(split.Label);
+        if (found == groupIndexes.end())
+        {
+            found = groupIndexes.emplace(split.Label, groups.size()).first;
+            groups.emplace_back();
+            groups.back().Label = split.Label;
+        }
+
+        AddCase(groups[found->second], split);
+        AddCase(all, split);
+    }
+
+    if (all.Cases.empty())
+    {
+        std::fprintf(stderr, "No corpus entries match the filter.\n");
+        return 1;
+    }
+
+    ReportHeader(csv);
+
+    for (const auto & group : groups)
+    {
+        Run(group, budget, csv);
+    }
+
+    Run(all, budget, csv);
+
+    return 0;
+}
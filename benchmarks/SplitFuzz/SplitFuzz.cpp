@@ -0,0 +1,296 @@
+//
+// SplitFuzz
+//
+// Differential fuzz target for StringExtensions::Split.  Each input is
+// split by Split and by the reference splitter (ReferenceSplit.h), with and
+// without removing empty items, and by SplitItems, and any difference
+// aborts with the input.
+//
+// An input is one byte giving the number of delimiters (its value mod 4),
+// that many delimiter bytes, then the argument.
+//
+// Built with SPLIT_FUZZ_LIBFUZZER defined and /fsanitize=fuzzer (MSVC) or
+// -fsanitize=fuzzer (clang), this is a libFuzzer target.  Otherwise it is a
+// standalone driver that mutates the Split corpus and random strings made
+// of the characters Split treats specially:
+//
+// Usage: SplitFuzz [--iterations n] [--seed n] [--corpus SplitCorpus.txt]
+//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ReferenceSplit.h"
+#include "SplitCorpus.h"
+#include "StringExtensions.h"
+
+using namespace Benchmarks;
+using Extensions::Strings::StringExtensions;
+
+namespace
+{
+    //
+    // Print a string with the bytes that aren't printable escaped.
+    //
+
+    void PrintEscaped(const char * label, const std::string & text)
+    {
+        std::fprintf(stderr, "%s \"", label);
+
+        for (unsigned char c : text)
+        {
+            if ((c >= ' ') && (c < 0x7f) && (c != '\\') && (c != '"'))
+            {
+                std::fputc(c, stderr);
+            }
+            else
+            {
+                std::fprintf(stderr, "\\x%02x", c);
+            }
+        }
+
+        std::fprintf(stderr, "\"\n");
+    }
+
+    void PrintItems(const char * label, const std::vector<std::string> & items)
+    {
+        std::fprintf(stderr, "%s %zu items\n", label, items.size());
+
+        for (const auto & item : items)
+        {
+            PrintEscaped("   ", item);
+        }
+    }
+
+    //
+    // Split contents both ways and abort if they differ.
+    //
+
+    void Check(const std::string & contents, const std::string & separators)
+    {
+        StringExtensions extension(contents);
+
+        for (bool removeEmpty : { false, true })
+        {
+            auto actual = extension.Split(separators, removeEmpty);
+            auto expected = ReferenceSplit(contents, separators, removeEmpty);
+
+            if (*actual != expected)
+            {
+                std::fprintf(stderr, "Split differs from the reference%s:\n", removeEmpty ? " removing empty items" : "");
+                PrintEscaped("  argument", contents);
+                PrintEscaped("  delimiters", separators);
+                PrintItems("  Split returned", *actual);
+                PrintItems("  reference returned", expected);
+                std::abort();
+            }
+        }
+
+        //
+        // The views must hold the same items.
+        //
+
+        static Extensions::Strings::SplitItems views;
+
+        views.Split(contents, separators);
+
+        std::vector<std::string> viewed(views.begin(), views.end());
+        auto expected = ReferenceSplit(contents, separators, false);
+
+        if (viewed != expected)
+        {
+            std::fprintf(stderr, "SplitItems differs from the reference:\n");
+            PrintEscaped("  argument", contents);
+            PrintEscaped("  delimiters", separators);
+            PrintItems("  SplitItems returned", viewed);
+            PrintItems("  reference returned", expected);
+            std::abort();
+        }
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    size_t separatorCount = data[0] % 4;
+    if (separatorCount + 1 > size)
+    {
+        return 0;
+    }
+
+    std::string separators(reinterpret_cast<const char *>(data + 1), separatorCount);
+    std::string contents(reinterpret_cast<const char *>(data + 1 + separatorCount), size - 1 - separatorCount);
+
+    Check(contents, separators);
+    return 0;
+}
+
+#if !defined(SPLIT_FUZZ_LIBFUZZER)
+
+namespace
+{
+    //
+    // Characters Split treats specially, weighted toward the ones that
+    // interact: quotes, backslashes and common delimiters.
+    //
+
+    const char Alphabet[] = "ab ,,,||;\"\"\"\\\\\\'x\t";
+
+    class Generator
+    {
+    public:
+
+        Generator(uint64_t seed)
+            : m_random(seed)
+        {
+        }
+
+        size_t Next(size_t bound)
+        {
+            return (size_t) (m_random() % bound);
+        }
+
+        char Character()
+        {
+            //
+            // Mostly the interesting characters, sometimes any byte.
+            //
+
+            if (Next(16) == 0)
+            {
+                return (char) Next(256);
+            }
+
+            return Alphabet[Next(sizeof(Alphabet) - 1)];
+        }
+
+        std::string Random(size_t maximumLength)
+        {
+            std::string text;
+
+            for (size_t length = Next(maximumLength + 1); length != 0; --length)
+            {
+                text.push_back(Character());
+            }
+
+            return text;
+        }
+
+        //
+        // Insert, delete or replace a few characters.
+        //
+
+        std::string Mutate(std::string text)
+        {
+            for (size_t edits = 1 + Next(4); edits != 0; --edits)
+            {
+                size_t position = text.empty() ? 0 : Next(text.size() + 1);
+
+                switch (Next(3))
+                {
+                    case 0:
+                        text.insert(text.begin() + position, Character());
+                        break;
+
+                    case 1:
+                        if (position < text.size())
+                        {
+                            text.erase(position, 1);
+                        }
+                        break;
+
+                    default:
+                        if (position < text.size())
+                        {
+                            text[position] = Character();
+                        }
+                        break;
+                }
+            }
+
+            return text;
+        }
+
+    private:
+
+        std::mt19937_64 m_random;
+    };
+}
+
+int main(int argc, char ** argv)
+{
+    uint64_t iterations = 1000000;
+    uint64_t seed = 1;
+    std::string corpusPath = "SplitCorpus.txt";
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg(argv[i]);
+
+        if ((arg == "--iterations") && (i + 1 < argc))
+        {
+            iterations = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if ((arg == "--seed") && (i + 1 < argc))
+        {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if ((arg == "--corpus") && (i + 1 < argc))
+        {
+            corpusPath = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--iterations n] [--seed n] [--corpus SplitCorpus.txt]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    //
+    // A missing corpus only loses the mutated cases.
+    //
+
+    SplitCorpus corpus;
+    std::string error;
+
+    if (!corpus.Load(corpusPath.c_str(), error))
+    {
+        std::fprintf(stderr, "%s; fuzzing random strings only.\n", error.c_str());
+    }
+
+    for (const auto & split : corpus.Cases)
+    {
+        Check(split.Contents, split.Separators);
+    }
+
+    Generator generator(seed);
+
+    for (uint64_t i = 0; i < iterations; ++i)
+    {
+        std::string separators = generator.Random(3);
+
+        if (!corpus.Cases.empty() && (generator.Next(2) == 0))
+        {
+            const SplitCase & split = corpus.Cases[generator.Next(corpus.Cases.size())];
+
+            Check(generator.Mutate(split.Contents), generator.Next(4) == 0 ? separators : split.Separators);
+        }
+        else
+        {
+            Check(generator.Random(64), separators);
+        }
+    }
+
+    std::printf("%llu inputs, no differences\n", (unsigned long long) iterations);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,398 @@
+//
+// Replay a member call trace recorded by /collections trace against the
+// collection types and report where the time and allocations went.
+//
+//  TraceReplay trace-file [--repeat n] [--csv]
+//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkSupport.h"
+#include "TraceReader.h"
+
+using namespace Benchmarks;
+using namespace Diagnostics::TraceFormat;
+
+namespace
+{
+    //
+    // Totals for one type and member.
+    //
+
+    struct MemberTotals
+    {
+        uint64_t Calls = 0;
+        uint64_t ReplayNanoseconds = 0;
+        uint64_t RecordedNanoseconds = 0;
+        uint64_t Allocations = 0;
+        uint64_t Mismatches = 0;
+    };
+
+    //
+    // Replays a trace once.
+    //
+
+    class Replayer
+    {
+    public:
+
+        Replayer(const Trace & trace, std::map<std::pair<uint32_t, uint32_t>, MemberTotals> & totals)
+            : m_trace(trace),
+              m_totals(totals)
+        {
+            //
+            // Resolve the type names once.
+            //
+
+            for (const auto & name : trace.Symbols)
+            {
+                m_types.push_back(name.empty()
+                                    ? nullptr
+                                    : Types::TypeMap::GetTypeInstanceForTypeName(name.c_str()));
+            }
+        }
+
+        //
+        // Run every record in the trace.  Variables still alive at the end
+        // are freed.
+        //
+
+        void Run()
+        {
+            for (const auto & record : m_trace.Records)
+            {
+                switch (record.Kind)
+                {
+                    case RecordKind::InitVariable:
+                        Init(record);
+                        break;
+
+                    case RecordKind::FreeVariable:
+                        Free(record);
+                        break;
+
+                    case RecordKind::GetMember:
+                        Member(record);
+                        break;
+
+                    case RecordKind::FromString:
+                        Assign(record);
+                        break;
+
+                    default:
+                        break;
+                }
+            }
+
+            for (auto & entry : m_objects)
+            {
+                Release(entry.second);
+            }
+
+            m_objects.clear();
+        }
+
+        //
+        // Number of records that couldn't be replayed because their type
+        // isn't registered.
+        //
+
+        uint64_t Skipped() const
+        {
+            return m_skipped;
+        }
+
+    private:
+
+        void Init(const TraceRecord & record)
+        {
+            MQ2Type * type = m_types[record.Type];
+            if (type == nullptr)
+            {
+                ++m_skipped;
+                return;
+            }
+
+            MQTypeVar variable;
+
+            variable.Type = type;
+            type->InitVariable(variable);
+
+            auto it = m_objects.find(record.Object);
+            if (it != m_objects.end())
+            {
+                Release(it->second);
+            }
+
+            m_objects[record.Object] = variable;
+        }
+
+        void Free(const TraceRecord & record)
+        {
+            auto it = m_objects.find(record.Object);
+            if (it == m_objects.end())
+            {
+                return;
+            }
+
+            Release(it->second);
+            m_objects.erase(it);
+        }
+
+        //
+        // Return the variable for an object id.  A variable that was
+        // created before the trace started is created now, empty.
+        //
+
+        MQTypeVar * Variable(uint32_t typeId, uint64_t object)
+        {
+            auto it = m_objects.find(object);
+            if (it != m_objects.end())
+            {
+                return &it->second;
+            }
+
+            MQ2Type * type = m_types[typeId];
+            if (type == nullptr)
+            {
+                return nullptr;
+            }
+
+            MQTypeVar variable;
+
+            variable.Type = type;
+            type->InitVariable(variable);
+
+            return &(m_objects[object] = variable);
+        }
+
+        void Member(const TraceRecord & record)
+        {
+            MQTypeVar * variable = Variable(record.Type, record.Object);
+            if (variable == nullptr)
+            {
+                ++m_skipped;
+                return;
+            }
+
+            //
+            // Members receive a writable index, as they do from MQ2.
+            //
+
+            char * index = nullptr;
+            if (record.HasIndex)
+            {
+                m_index.assign(record.Argument.begin(), record.Argument.end());
+                m_index.push_back('\0');
+                index = m_index.data();
+            }
+
+            MQTypeVar dest;
+
+            dest.Ptr = nullptr;
+            dest.Type = nullptr;
+
+            AllocationCount before = CurrentAllocations();
+            auto start = std::chrono::steady_clock::now();
+
+            bool result = variable->Type->GetMember(*variable, m_trace.Symbols[record.Member].c_str(), index, dest);
+
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            AllocationCount after = CurrentAllocations();
+
+            auto & totals = m_totals[std::make_pair(record.Type, record.Member)];
+
+            totals.Calls += 1;
+            totals.ReplayNanoseconds += (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            totals.RecordedNanoseconds += record.ElapsedNanoseconds;
+            totals.Allocations += after.Allocations - before.Allocations;
+
+            if (!Matches(record, result, dest))
+            {
+                totals.Mismatches += 1;
+            }
+
+            if ((record.Result == ResultKind::Object) && (dest.Type != nullptr))
+            {
+                //
+                // The member returned a variable; later records refer to
+                // it by the recorded id.
+                //
+
+                m_objects[record.ResultObject] = dest;
+            }
+        }
+
+        void Assign(const TraceRecord & record)
+        {
+            MQTypeVar * variable = Variable(record.Type, record.Object);
+            if (variable == nullptr)
+            {
+                ++m_skipped;
+                return;
+            }
+
+            variable->Type->FromString(*variable, record.Argument.c_str());
+        }
+
+        //
+        // Return true if a replayed call produced the recorded result.
+        //
+
+        bool Matches(const TraceRecord & record, bool result, const MQTypeVar & dest) const
+        {
+            if (result != record.Succeeded)
+            {
+                return false;
+            }
+
+            switch (record.Result)
+            {
+                case ResultKind::String:
+                    return (dest.Ptr != nullptr)
+                        && (record.ResultString == reinterpret_cast<const char *>(dest.Ptr));
+
+                case ResultKind::Integer:
+                    return dest.Int == record.ResultInteger;
+
+                case ResultKind::Object:
+                    return dest.Type == m_types[record.ResultType];
+
+                default:
+                    return true;
+            }
+        }
+
+        const Trace & m_trace;
+        std::map<std::pair<uint32_t, uint32_t>, MemberTotals> & m_totals;
+        std::vector<MQ2Type *> m_types;
+        std::unordered_map<uint64_t, MQTypeVar> m_objects;
+        std::vector<char> m_index;
+        uint64_t m_skipped = 0;
+    };
+
+    void Usage()
+    {
+        std::fprintf(stderr, "usage: TraceReplay trace-file [--repeat n] [--csv]\n");
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    const char * path = nullptr;
+    int repeat = 1;
+    bool csv = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((std::strcmp(argv[i], "--repeat") == 0) && (i + 1 < argc))
+        {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else if ((argv[i][0] != '-') && (path == nullptr))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            Usage();
+            return 2;
+        }
+    }
+
+    if (path == nullptr)
+    {
+        Usage();
+        return 2;
+    }
+
+    Trace trace;
+    std::string error;
+
+    if (!trace.Load(path, error))
+    {
+        std::fprintf(stderr, "%s: %s\n", path, error.c_str());
+        return 1;
+    }
+
+    RegisterTypes();
+
+    std::map<std::pair<uint32_t, uint32_t>, MemberTotals> totals;
+    uint64_t skipped = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (int pass = 0; pass < repeat; ++pass)
+    {
+        Replayer replayer(trace, totals);
+
+        replayer.Run();
+        skipped += replayer.Skipped();
+    }
+
+    auto wall = std::chrono::steady_clock::now() - start;
+
+    //
+    // Report the members in order of the time spent in them.
+    //
+
+    std::vector<std::pair<std::string, MemberTotals>> rows;
+    for (const auto & entry : totals)
+    {
+        rows.emplace_back(trace.Symbols[entry.first.first] + "." + trace.Symbols[entry.first.second], entry.second);
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const auto & a, const auto & b)
+    {
+        return a.second.ReplayNanoseconds > b.second.ReplayNanoseconds;
+    });
+
+    if (csv)
+    {
+        std::printf("member,calls,total_ms,ns_per_op,recorded_ns_per_op,allocs_per_op,mismatches\n");
+    }
+    else
+    {
+        std::printf("%-24s %12s %10s %10s %12s %10s %10s\n",
+                    "member", "calls", "total ms", "ns/op", "recorded/op", "allocs/op", "mismatch");
+    }
+
+    for (const auto & row : rows)
+    {
+        const MemberTotals & t = row.second;
+
+        std::printf(csv ? "%s,%llu,%.3f,%.1f,%.1f,%.2f,%llu\n"
+                        : "%-24s %12llu %10.3f %10.1f %12.1f %10.2f %10llu\n",
+                    row.first.c_str(),
+                    (unsigned long long) t.Calls,
+                    t.ReplayNanoseconds / 1e6,
+                    (double) t.ReplayNanoseconds / t.Calls,
+                    (double) t.RecordedNanoseconds / t.Calls,
+                    (double) t.Allocations / t.Calls,
+                    (unsigned long long) t.Mismatches);
+    }
+
+    if (!csv)
+    {
+        std::printf("\n%zu records, %d pass(es), %.1f ms wall, %llu skipped\n",
+                    trace.Records.size(),
+                    repeat,
+                    std::chrono::duration_cast<std::chrono::microseconds>(wall).count() / 1e3,
+                    (unsigned long long) skipped);
+    }
+
+    UnregisterTypes();
+    return 0;
+}
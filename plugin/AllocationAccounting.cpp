@@ -0,0 +1,289 @@
+//
+// Replace the global allocation functions with versions that count
+// allocations for the process and for the member being executed.
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <utility>
+
+#if defined(MQ2COLLECTIONS_HEADLESS) && (defined(_WIN32) || defined(__linux__))
+#include <malloc.h>
+#define TRACK_LIVE_BYTES
+#endif
+
+#include "AllocationAccounting.h"
+#include "Diagnostics.h"
+
+using namespace Diagnostics;
+
+namespace
+{
+    std::atomic<uint64_t> allocationCount(0);
+    std::atomic<uint64_t> allocationBytes(0);
+
+#if defined(TRACK_LIVE_BYTES)
+    std::atomic<uint64_t> liveBytes(0);
+
+    //
+    // Return the size of a block as the heap sees it.  Only headless builds
+    // track the bytes in use; inside the client it would cost every free a
+    // heap lookup.
+    //
+
+    size_t BlockSize(void * block)
+    {
+#if defined(_WIN32)
+        return block != nullptr ? _msize(block) : 0;
+#else
+        return malloc_usable_size(block);
+#endif
+    }
+#endif
+
+    //
+    // Return true if the process totals are counted.  Headless builds always
+    // count them for the benchmarks; inside the client they are counted only
+    // while allocation accounting is enabled, so that the plugin's
+    // allocations don't pay for atomic updates nobody reads.
+    //
+
+    bool Counting()
+    {
+#if defined(MQ2COLLECTIONS_HEADLESS)
+        return true;
+#else
+        return Instrumentation::Enabled(Instrumentation::Allocations);
+#endif
+    }
+
+    //
+    // Release a block allocated by CountedAllocate.  The global malloc and
+    // free are named explicitly: a debug build maps them onto the CRT's
+    // debug heap with macros, which don't expand inside namespace std.
+    //
+
+    void CountedFree(void * block)
+    {
+#if defined(TRACK_LIVE_BYTES)
+        liveBytes.fetch_sub(BlockSize(block), std::memory_order_relaxed);
+#endif
+        ::free(block);
+    }
+
+    //
+    // Member being charged on this thread or null.
+    //
+
+    thread_local AllocationAccounting::MemberAllocations * current = nullptr;
+
+    //
+    // Counts for each type and member, keyed on the addresses of their
+    // names.  Entries are never removed, so pointers to them stay valid.
+    //
+
+    std::map<std::pair<const char *, const char *>, AllocationAccounting::MemberAllocations> & Members()
+    {
+        static std::map<std::pair<const char *, const char *>, AllocationAccounting::MemberAllocations> members;
+
+        return members;
+    }
+
+    //
+    // Allocate a block and count it.  Throw std::bad_alloc on failure unless
+    // the caller asked for a null return.
+    //
+
+    void * CountedAllocate(size_t size, bool nothrow)
+    {
+        if (Counting())
+        {
+            allocationCount.fetch_add(1, std::memory_order_relaxed);
+            allocationBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+
+        if (current != nullptr)
+        {
+            current->Allocations += 1;
+            current->Bytes += size;
+        }
+
+        void * block = ::malloc(size == 0 ? 1 : size);
+        if (block == nullptr)
+        {
+            if (!nothrow)
+            {
+                throw std::bad_alloc();
+            }
+
+            return nullptr;
+        }
+
+#if defined(TRACK_LIVE_BYTES)
+        liveBytes.fetch_add(BlockSize(block), std::memory_order_relaxed);
+#endif
+
+        return block;
+    }
+}
+
+//
+// Charge allocations to a type and member until the scope ends.
+//
+
+AllocationAccounting::Scope::Scope(const char * type, const char * member)
+    : m_previous(current)
+{
+    //
+    // Find the entry before making it current, so creating it isn't
+    // charged to the member.
+    //
+
+    current = nullptr;
+
+    auto & entry = Members()[std::make_pair(type, member)];
+
+    entry.Type = type;
+    entry.Member = member;
+    entry.Calls += 1;
+
+    current = &entry;
+}
+
+AllocationAccounting::Scope::~Scope()
+{
+    current = m_previous;
+}
+
+//
+// Start or stop attributing allocations to members.
+//
+
+void AllocationAccounting::Enable(bool enable)
+{
+    Instrumentation::Enable(Instrumentation::Allocations, enable);
+}
+
+//
+// Return true if allocations are being attributed to members.
+//
+
+bool AllocationAccounting::Enabled()
+{
+    return Instrumentation::Enabled(Instrumentation::Allocations);
+}
+
+//
+// Return the allocations made by the process since it started, or in the
+// plugin, while accounting has been enabled.
+//
+
+AllocationAccounting::Totals AllocationAccounting::ProcessTotals()
+{
+    return Totals
+    {
+        allocationCount.load(std::memory_order_relaxed),
+        allocationBytes.load(std::memory_order_relaxed)
+    };
+}
+
+//
+// Return the number of heap bytes in use, including the heap's rounding,
+// or 0 if it isn't tracked.
+//
+
+uint64_t AllocationAccounting::LiveBytes()
+{
+#if defined(TRACK_LIVE_BYTES)
+    return liveBytes.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+//
+// Return the allocations attributed to each member that has been called
+// since accounting was enabled or last reset.
+//
+
+std::vector<AllocationAccounting::MemberAllocations> AllocationAccounting::Snapshot()
+{
+    std::vector<MemberAllocations> result;
+
+    for (const auto & entry : Members())
+    {
+        if (entry.second.Calls != 0)
+        {
+            result.push_back(entry.second);
+        }
+    }
+
+    return result;
+}
+
+//
+// Discard the per member counts.  The entries are kept because a scope may
+// still refer to them.
+//
+
+void AllocationAccounting::Reset()
+{
+    for (auto & entry : Members())
+    {
+        entry.second.Calls = 0;
+        entry.second.Allocations = 0;
+        entry.second.Bytes = 0;
+    }
+}
+
+void * operator new(size_t size)
+{
+    return CountedAllocate(size, false);
+}
+
+void * operator new[](size_t size)
+{
+    return CountedAllocate(size, false);
+}
+
+void * operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size, true);
+}
+
+void * operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return CountedAllocate(size, true);
+}
+
+void operator delete(void * block) noexcept
+{
+    CountedFree(block);
+}
+
+void operator delete[](void * block) noexcept
+{
+    CountedFree(block);
+}
+
+void operator delete(void * block, size_t) noexcept
+{
+    CountedFree(block);
+}
+
+void operator delete[](void * block, size_t) noexcept
+{
+    CountedFree(block);
+}
+
+void operator delete(void * block, const std::nothrow_t &) noexcept
+{
+    CountedFree(block);
+}
+
+void operator delete[](void * block, const std::nothrow_t &) noexcept
+{
+    CountedFree(block);
+}
@@ -0,0 +1,108 @@
+//
+// AllocationAccounting.h
+//
+// Count heap allocations made through the global operator new and, while
+// accounting is enabled, attribute them to the collection type and member
+// that made them.  AllocationAccounting.cpp replaces the global allocation
+// functions of the module it is linked into.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Diagnostics
+{
+    class AllocationAccounting
+    {
+    public:
+
+        //
+        // Allocation totals.
+        //
+
+        struct Totals
+        {
+            uint64_t Allocations;
+            uint64_t Bytes;
+        };
+
+        //
+        // Allocations made by one member of a type.  Type and Member point
+        // at the names in the type's member table.
+        //
+
+        struct MemberAllocations
+        {
+            const char * Type;
+            const char * Member;
+            uint64_t Calls;
+            uint64_t Allocations;
+            uint64_t Bytes;
+        };
+
+        //
+        // Attribute the allocations made while an instance is alive to a
+        // type and member.  Scopes nest; the innermost one is charged.
+        //
+
+        class Scope
+        {
+        public:
+
+            Scope(const char * type, const char * member);
+            ~Scope();
+
+            Scope(const Scope &) = delete;
+            Scope & operator=(const Scope &) = delete;
+
+        private:
+
+            MemberAllocations * m_previous;
+        };
+
+        //
+        // Start or stop attributing allocations to members.  Headless
+        // builds always count the process wide totals; the plugin counts
+        // them only while accounting is enabled.
+        //
+
+        static void Enable(bool enable);
+
+        //
+        // Return true if allocations are being attributed to members.
+        //
+
+        static bool Enabled();
+
+        //
+        // Return the allocations made by the process since it started, or
+        // in the plugin, while accounting has been enabled.
+        //
+
+        static Totals ProcessTotals();
+
+        //
+        // Return the number of heap bytes in use, including the heap's
+        // rounding.  This is only tracked by headless builds on Windows and
+        // Linux; otherwise it is 0.
+        //
+
+        static uint64_t LiveBytes();
+
+        //
+        // Return the allocations attributed to each member that has been
+        // called since accounting was enabled or last reset.
+        //
+
+        static std::vector<MemberAllocations> Snapshot();
+
+        //
+        // Discard the per member counts.
+        //
+
+        static void Reset();
+    };
+}
@@ -0,0 +1,267 @@
+//
+// ArgumentCache.cpp
+//
+// A small set associative cache of split member arguments.
+//
+
+#include "ArgumentCache.h"
+
+#include <array>
+#include <utility>
+
+using namespace Collections;
+using namespace Extensions::Strings;
+
+namespace
+{
+    //
+    // Each argument hashes to a set of Ways entries; a new argument replaces
+    // the entry in its set that was used least recently.
+    //
+
+    const size_t Ways = 2;
+    const size_t Sets = ArgumentCache::Capacity / Ways;
+
+    static_assert((Sets & (Sets - 1)) == 0, "The number of sets must be a power of two.");
+
+    struct Entry
+    {
+        uint64_t Hash = 0;
+        const char * Type = nullptr;
+        const char * Member = nullptr;
+        bool Trim = false;
+        bool Valid = false;
+        uint64_t LastUse = 0;
+        std::string Separators;
+        std::string Text;
+        std::vector<std::string> Items;
+    };
+
+    struct Cache
+    {
+        std::array<Entry, ArgumentCache::Capacity> Entries;
+        uint64_t Clock = 0;
+        uint64_t Hits = 0;
+        uint64_t Misses = 0;
+
+        //
+        // Items of an argument that isn't remembered.
+        //
+
+        std::vector<std::string> Uncached;
+
+        //
+        // Views of the items of the argument being split.
+        //
+
+        SplitItems Splits;
+
+        //
+        // Quoted and escaped items of a long argument being split.
+        //
+
+        std::string LongArgument;
+    };
+
+    Cache & TheCache()
+    {
+        static Cache cache;
+
+        return cache;
+    }
+
+    //
+    // FNV-1a over the text and separators, mixed with the member and the
+    // trim flag.
+    //
+
+    uint64_t Hash(const char * type, const char * member, std::string_view text, const std::string & separators, bool trim)
+    {
+        uint64_t hash = 14695981039346656037ull;
+
+        auto mix = [&hash](uint64_t value)
+        {
+            hash = (hash ^ value) * 1099511628211ull;
+        };
+
+        for (char c : text)
+        {
+            mix((unsigned char) c);
+        }
+
+        mix(0x100);
+
+        for (char c : separators)
+        {
+            mix((unsigned char) c);
+        }
+
+        mix((uint64_t) (uintptr_t) type);
+        mix((uint64_t) (uintptr_t) member);
+        mix(trim ? 1 : 0);
+
+        return hash ^ (hash >> 29);
+    }
+
+    //
+    // Split text into items, trimming each one if asked.  The strings
+    // already in items are reused.
+    //
+
+    void SplitInto(std::vector<std::string> & items, std::string_view text, const std::string & separators, bool trim)
+    {
+        SplitItems & splits = TheCache().Splits;
+
+        splits.Split(text, separators, trim);
+        items.resize(splits.size());
+
+        for (size_t index = 0; index < splits.size(); ++index)
+        {
+            items[index].assign(splits[index]);
+        }
+    }
+}
+
+//
+// Return the split argument, from the cache if it has been seen recently.
+//
+
+const std::vector<std::string> & ArgumentCache::Split(
+                    const char * type,
+                    const char * member,
+                    std::string_view text,
+                    const std::string & separators,
+                    bool trim)
+{
+    Cache & cache = TheCache();
+
+    //
+    // An argument without separators, quotes or escapes is a single item, as
+    // is any argument when there are no separators.  There is nothing to
+    // tokenize, so don't spend an entry on it.
+    //
+
+    if (separators.empty()
+        || ((text.find_first_of(separators) == std::string_view::npos)
+            && (text.find_first_of("\"\\") == std::string_view::npos)))
+    {
+        if (trim)
+        {
+            text = TrimView(text);
+        }
+
+        cache.Uncached.resize(1);
+        cache.Uncached[0].assign(text);
+
+        return cache.Uncached;
+    }
+
+    if (text.size() > MaximumLength)
+    {
+        ++cache.Misses;
+        SplitInto(cache.Uncached, text, separators, trim);
+
+        return cache.Uncached;
+    }
+
+    uint64_t hash = Hash(type, member, text, separators, trim);
+    Entry * set = &cache.Entries[(hash & (Sets - 1)) * Ways];
+    Entry * victim = set;
+
+    ++cache.Clock;
+
+    for (size_t way = 0; way < Ways; ++way)
+    {
+        Entry & entry = set[way];
+
+        if (entry.Valid
+            && (entry.Hash == hash)
+            && (entry.Type == type)
+            && (entry.Member == member)
+            && (entry.Trim == trim)
+            && (entry.Text == text)
+            && (entry.Separators == separators))
+        {
+            ++cache.Hits;
+            entry.LastUse = cache.Clock;
+
+            return entry.Items;
+        }
+
+        if (!entry.Valid || (entry.LastUse < victim->LastUse))
+        {
+            victim = &entry;
+        }
+    }
+
+    //
+    // Replace the least recently used entry.  Assigning reuses the storage
+    // the entry already has.
+    //
+
+    ++cache.Misses;
+
+    victim->Hash = hash;
+    victim->Type = type;
+    victim->Member = member;
+    victim->Trim = trim;
+    victim->Valid = true;
+    victim->LastUse = cache.Clock;
+    victim->Separators = separators;
+    victim->Text.assign(text);
+    SplitInto(victim->Items, text, separators, trim);
+
+    return victim->Items;
+}
+
+std::string & ArgumentCache::LongArgument()
+{
+    Cache & cache = TheCache();
+
+    ++cache.Misses;
+    cache.LongArgument.clear();
+
+    return cache.LongArgument;
+}
+
+uint64_t ArgumentCache::Hits()
+{
+    return TheCache().Hits;
+}
+
+uint64_t ArgumentCache::Misses()
+{
+    return TheCache().Misses;
+}
+
+void ArgumentCache::ResetCounts()
+{
+    Cache & cache = TheCache();
+
+    cache.Hits = 0;
+    cache.Misses = 0;
+}
+
+void ArgumentCache::Clear()
+{
+    Cache & cache = TheCache();
+
+    //
+    // Swap rather than assign, so that the strings' storage is freed and not
+    // kept for reuse.
+    //
+
+    for (auto & entry : cache.Entries)
+    {
+        Entry empty;
+
+        std::swap(entry, empty);
+    }
+
+    std::vector<std::string>().swap(cache.Uncached);
+
+    SplitItems splits;
+
+    std::swap(cache.Splits, splits);
+    std::string().swap(cache.LongArgument);
+}
@@ -0,0 +1,122 @@
+//
+// ArgumentCache.h
+//
+// Remember how recent member arguments were split, so that a macro passing
+// the same literal argument in a loop (${l.Append[a,b,c]},
+// ${m.Add[key,value]}) doesn't tokenize it on every call.
+//
+
+#pragma once
+#include "DebugMemory.h"
+#include "StringExtensions.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Collections
+{
+    class ArgumentCache
+    {
+    public:
+
+        //
+        // Number of arguments remembered and the longest argument that is
+        // remembered.  Longer arguments are split on every call.
+        //
+
+        static const size_t Capacity = 256;
+        static const size_t MaximumLength = 256;
+
+        //
+        // Return the items of text split on any of separators, trimming
+        // each item if trim is true.  Type and member name the member the
+        // argument was passed to and must be string literals: the cache
+        // compares the pointers.  Together with the separators, trim and
+        // the text they identify a cached result.
+        //
+        // Arguments that are a single item aren't cached and don't count as
+        // hits or misses.  The items are valid until the next call.
+        //
+
+        static const std::vector<std::string> & Split(
+                            const char * type,
+                            const char * member,
+                            std::string_view text,
+                            const std::string & separators,
+                            bool trim = false);
+
+        //
+        // Call add with each item of text, as a std::string_view, split on
+        // any of separators.  A short argument is split through the cache.
+        // One too long to remember is split straight into add, so a bulk
+        // load makes no string for an item before add stores it.  That
+        // counts as a miss.
+        //
+
+        template <typename Add>
+        static void ForEach(
+                        const char * type,
+                        const char * member,
+                        std::string_view text,
+                        const std::string & separators,
+                        Add && add)
+        {
+            if (text.size() <= MaximumLength)
+            {
+                for (const auto & item : Split(type, member, text, separators))
+                {
+                    add(std::string_view(item));
+                }
+
+                return;
+            }
+
+            std::string & unquoted = LongArgument();
+
+            Extensions::Strings::SplitText(text,
+                                           separators,
+                                           unquoted,
+                                           [&add, &unquoted] (std::string_view item, bool fromUnquoted)
+                                           {
+                                               add(item);
+
+                                               if (fromUnquoted)
+                                               {
+                                                   unquoted.clear();
+                                               }
+                                           });
+        }
+
+        //
+        // Return the number of calls answered from the cache and the number
+        // that split the argument.
+        //
+
+        static uint64_t Hits();
+        static uint64_t Misses();
+
+        //
+        // Zero the hit and miss counts.
+        //
+
+        static void ResetCounts();
+
+        //
+        // Forget every cached argument.
+        //
+
+        static void Clear();
+
+    private:
+
+        //
+        // Count a miss for a long argument and return an empty string to
+        // build its quoted and escaped items in.
+        //
+
+        static std::string & LongArgument();
+    };
+}  // namespace Collections
@@ -6,6 +6,7 @@
 
 #include "DebugMemory.h"
 
+#include <string>
 #include <vector>
 
 namespace Utilities
@@ -96,5 +97,45 @@ namespace Utilities
 
             std::vector<T> m_Buffer;
         };
+
+        //
+        // Hold the string most recently removed from a collection of type
+        // Owner, such as the item returned by a queue's Pop.  The removed
+        // string is moved into the slot, so its characters aren't copied,
+        // and MQ2 is handed a pointer to them.  The pointer is valid until
+        // the next removal from any collection of that type; MQ2 copies a
+        // string result before it evaluates anything else.
+        //
+        // Results that aren't removed from the collection don't need a
+        // slot: they point at the string the collection holds.
+        //
+        // Like the type map, the slot is only used from the game thread.
+        //
+
+        template<typename Owner>
+        class ResultSlot
+        {
+        public:
+
+            //
+            // Return the slot to move a result into.
+            //
+
+            static std::string & Value()
+            {
+                static std::string value;
+
+                return value;
+            }
+
+            //
+            // Return the characters of the result in the slot.
+            //
+
+            static const char * Pointer()
+            {
+                return Value().c_str();
+            }
+        };
     }  // namespace Buffers
 }  // namespace Utilities
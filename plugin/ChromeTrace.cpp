@@ -0,0 +1,219 @@
+//
+// Capture collection operations and write them as Chrome trace JSON.
+//
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "ChromeTrace.h"
+#include "Diagnostics.h"
+
+using namespace Diagnostics;
+
+namespace
+{
+    //
+    // Characters of an operation's index kept with the event.
+    //
+
+    const size_t IndexLength = 39;
+
+    //
+    // One captured operation.
+    //
+
+    struct Event
+    {
+        const char * Type;
+        const char * Name;
+        uint64_t Start;
+        uint64_t Duration;
+        bool HasIndex;
+        char Index[IndexLength + 1];
+    };
+
+    //
+    // Ring buffer of events.  next is the slot the next event is written
+    // to and count the number of valid events.
+    //
+
+    std::vector<Event> events;
+    size_t next;
+    size_t count;
+
+    //
+    // Time of the first event written, so timestamps start near zero.
+    //
+
+    uint64_t origin;
+
+    //
+    // Write a string as a JSON string literal.
+    //
+
+    void WriteJsonString(std::FILE * file, const char * value)
+    {
+        std::fputc('"', file);
+
+        for (const unsigned char * p = reinterpret_cast<const unsigned char *>(value); *p; ++p)
+        {
+            switch (*p)
+            {
+                case '"':
+                    std::fputs("\\\"", file);
+                    break;
+
+                case '\\':
+                    std::fputs("\\\\", file);
+                    break;
+
+                default:
+                    if (*p < 0x20)
+                    {
+                        std::fprintf(file, "\\u%04x", *p);
+                    }
+                    else
+                    {
+                        std::fputc(*p, file);
+                    }
+                    break;
+            }
+        }
+
+        std::fputc('"', file);
+    }
+}
+
+//
+// Start capturing operations into a ring buffer holding capacity events,
+// discarding any events already captured.
+//
+
+void ChromeTrace::Start(size_t capacity)
+{
+    events.assign(capacity != 0 ? capacity : DefaultCapacity, Event());
+    next = 0;
+    count = 0;
+    origin = Now();
+
+    Instrumentation::Enable(Instrumentation::Timeline, true);
+}
+
+//
+// Stop capturing operations.
+//
+
+void ChromeTrace::Stop()
+{
+    Instrumentation::Enable(Instrumentation::Timeline, false);
+}
+
+//
+// Return true if operations are being captured.
+//
+
+bool ChromeTrace::Enabled()
+{
+    return Instrumentation::Enabled(Instrumentation::Timeline);
+}
+
+//
+// Return the number of events in the ring buffer.
+//
+
+size_t ChromeTrace::Size()
+{
+    return count;
+}
+
+//
+// Return the current time on the trace clock, in nanoseconds.
+//
+
+uint64_t ChromeTrace::Now()
+{
+    return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//
+// Capture an operation on a type.
+//
+
+void ChromeTrace::Record(const char * type,
+                         const char * name,
+                         const char * index,
+                         uint64_t start,
+                         uint64_t end)
+{
+    if (events.empty())
+    {
+        return;
+    }
+
+    Event & event = events[next];
+
+    event.Type = type;
+    event.Name = name;
+    event.Start = start;
+    event.Duration = end - start;
+    event.HasIndex = index != nullptr;
+
+    if (index != nullptr)
+    {
+        std::strncpy(event.Index, index, IndexLength);
+        event.Index[IndexLength] = '\0';
+    }
+
+    next = (next + 1) % events.size();
+    if (count < events.size())
+    {
+        ++count;
+    }
+}
+
+//
+// Write the events in the ring buffer, oldest first, as Chrome trace JSON.
+// Each event is a complete ("X") event: its begin time and duration.
+//
+
+bool ChromeTrace::Save(const char * path)
+{
+    std::FILE * file = std::fopen(path, "w");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", file);
+
+    size_t first = (next + events.size() - count) % (events.empty() ? 1 : events.size());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const Event & event = events[(first + i) % events.size()];
+
+        std::fputs(i == 0 ? "{\"name\":\"" : ",\n{\"name\":\"", file);
+        std::fprintf(file, "%s.%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f",
+                     event.Type,
+                     event.Name,
+                     event.Type,
+                     (event.Start - origin) / 1e3,
+                     event.Duration / 1e3);
+
+        if (event.HasIndex)
+        {
+            std::fputs(",\"args\":{\"index\":", file);
+            WriteJsonString(file, event.Index);
+            std::fputc('}', file);
+        }
+
+        std::fputc('}', file);
+    }
+
+    std::fputs("\n]}\n", file);
+
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,78 @@
+//
+// ChromeTrace.h
+//
+// Keep the most recent collection operations in a ring buffer and write them
+// out in the Chrome trace event format, which chrome://tracing and Perfetto
+// load directly.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Diagnostics
+{
+    class ChromeTrace
+    {
+    public:
+
+        //
+        // Events kept when no capacity is given.
+        //
+
+        static const size_t DefaultCapacity = 64 * 1024;
+
+        //
+        // Start capturing operations into a ring buffer holding capacity
+        // events, discarding any events already captured.
+        //
+
+        static void Start(size_t capacity = DefaultCapacity);
+
+        //
+        // Stop capturing operations.  The captured events are kept until
+        // the next Start.
+        //
+
+        static void Stop();
+
+        //
+        // Return true if operations are being captured.
+        //
+
+        static bool Enabled();
+
+        //
+        // Return the number of events in the ring buffer.
+        //
+
+        static size_t Size();
+
+        //
+        // Return the current time on the trace clock, in nanoseconds.
+        //
+
+        static uint64_t Now();
+
+        //
+        // Capture an operation on a type.  name is the member or operation
+        // name and index, which may be null, its argument.  type and name
+        // must remain valid; index is copied.
+        //
+
+        static void Record(const char * type,
+                           const char * name,
+                           const char * index,
+                           uint64_t start,
+                           uint64_t end);
+
+        //
+        // Write the events in the ring buffer, oldest first, as Chrome trace
+        // JSON.  Return false if the file can't be written.
+        //
+
+        static bool Save(const char * path);
+    };
+}
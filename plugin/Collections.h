@@ -8,7 +8,9 @@
 
 #include "DebugMemory.h"
 
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 namespace Collections
 {
@@ -22,6 +24,12 @@ namespace Collections
     // Next			- Advance the iterator to the next element.
     // IsEnd		- Is the iterator at the end of the collection?
     //
+    // None of these are virtual.  Every iterator walks a standard container
+    // the same way, and the member functions of each concrete iterator call
+    // them on their own type, so the compiler can inline them.  Only the
+    // destructor is virtual, so that Release can delete the concrete
+    // iterator.
+    //
 
     template<class coll>
     class IteratorBase
@@ -34,19 +42,22 @@ namespace Collections
 
         explicit IteratorBase(const coll & collection)
             : m_refCollection(collection),
-              m_cloned(false)
+              m_holders(0),
+              m_variables(0)
         {
             Reset();
         }
 
         //
-        // Copy the iterator. The copy is cloned and can/must be deleted.
+        // Copy the iterator.  Nothing holds the copy until a variable
+        // takes it.
         //
 
         explicit IteratorBase(const IteratorBase & original)
             : m_refCollection(original.m_refCollection),
               m_iterator(original.m_iterator),
-              m_cloned(true)
+              m_holders(0),
+              m_variables(0)
         {
         }
 
@@ -62,7 +73,7 @@ namespace Collections
         // Reset the iterator to the start of the collection.
         //
 
-        virtual void Reset()
+        void Reset()
         {
             m_iterator = m_refCollection.begin();
         }
@@ -72,7 +83,7 @@ namespace Collections
         // and false otherwise.
         //
 
-        virtual bool Advance()
+        bool Advance()
         {
             if (m_iterator != m_refCollection.end())
             {
@@ -87,22 +98,80 @@ namespace Collections
         // Return true if the iterator is at the end of the collection.
         //
 
-        virtual bool IsEnd() const
+        bool IsEnd() const
         {
             return m_refCollection.end() == m_iterator;
         }
 
-    protected:
+        //
+        // An iterator is kept alive by its collection, which holds the one
+        // it last returned from First or Find, and by each variable that was
+        // given it with /vardata.  It is deleted when the collection has let
+        // go and no variable holds it.
+        //
+        // A clone is held by nothing until a variable takes it, so releasing
+        // it from the variable it was returned to deletes it.
+        //
+
+        enum Holder : uint8_t
+        {
+            HeldByCollection = 1
+        };
+
+        void Take(Holder holder)
+        {
+            m_holders |= holder;
+        }
+
+        void Release(Holder holder)
+        {
+            if ((m_holders & holder) != 0)
+            {
+                m_holders &= ~holder;
+                DeleteIfUnheld();
+            }
+        }
+
+        //
+        // Count a variable taking or letting go of the iterator.
+        //
+
+        void TakeVariable()
+        {
+            ++m_variables;
+        }
+
+        void ReleaseVariable()
+        {
+            if (m_variables != 0)
+            {
+                --m_variables;
+            }
+
+            DeleteIfUnheld();
+        }
 
         //
-        // Was this iterator cloned?
+        // Return true if a holder has taken the iterator.
         //
 
-        const bool Cloned() const
+        bool HeldBy(Holder holder) const
         {
-            return m_cloned;
+            return (m_holders & holder) != 0;
         }
 
+    private:
+
+        void DeleteIfUnheld()
+        {
+            if ((m_holders == 0) && (m_variables == 0))
+            {
+                delete this;
+            }
+        }
+
+    protected:
+
         //
         // Iterator on m_refCollection.
         //
@@ -116,10 +185,12 @@ namespace Collections
         const coll & m_refCollection;
 
         //
-        // Was this iterator cloned?
+        // Holders keeping the iterator alive and the number of variables
+        // holding it.
         //
 
-        const bool m_cloned;
+        uint8_t m_holders;
+        uint32_t m_variables;
     };
 
     //
@@ -131,7 +202,7 @@ namespace Collections
     // Value		- Return the value under the current iterator
     //
 
-    template<class coll, typename ValueType = coll::value_type>
+    template<class coll, typename ValueType = typename coll::value_type>
     class ValueIterator : public IteratorBase<coll>
     {
     public:
@@ -141,7 +212,7 @@ namespace Collections
         //
 
         explicit ValueIterator(const coll & collection)
-            : IteratorBase(collection)
+            : IteratorBase<coll>(collection)
         {
         }
 
@@ -150,25 +221,44 @@ namespace Collections
         //
 
         explicit ValueIterator(const ValueIterator & iter)
-            : IteratorBase(iter)
+            : IteratorBase<coll>(iter)
         {
         }
 
         //
-        // Destroy the iterator.
+        // Return the value under the current iterator through the item parameter.
+        // True is returned if item is valid and false if it is not.  Item is
+        // not valid if the iterator points after the end of the collection.
         //
 
-        virtual ~ValueIterator()
+        bool Value(const ValueType ** const item) const
         {
+            if (this->IsEnd())
+            {
+                return false;
+            }
+
+            *item = ValueOf(*this->m_iterator);
+            return true;
         }
 
+    private:
+
         //
-        // Return the value under the current iterator through the item parameter.
-        // True is returned if item is valid and false if it is not.  Item is
-        // not valid if the iterator points after the end of the collection.
+        // The value of an element is the element itself, or the mapped
+        // value of a key and value pair.
         //
 
-        virtual bool Value(const ValueType ** const item) const = 0;
+        static const ValueType * ValueOf(const ValueType & element)
+        {
+            return &element;
+        }
+
+        template<typename KeyType>
+        static const ValueType * ValueOf(const std::pair<const KeyType, ValueType> & element)
+        {
+            return &element.second;
+        }
     };
 
     //
@@ -190,7 +280,7 @@ namespace Collections
         //
 
         explicit KeyValueIterator(const coll & collection)
-            : ValueIterator(collection)
+            : ValueIterator<coll, ValueType>(collection)
         {
         }
 
@@ -199,27 +289,90 @@ namespace Collections
         //
 
         explicit KeyValueIterator(const KeyValueIterator & iter)
-            : ValueIterator(iter)
+            : ValueIterator<coll, ValueType>(iter)
         {
         }
 
         //
-        // Destroy the iterator.
+        // Return the key under the current iterator through the key parameter.
+        // True is returned if key is valid and false if it is not.  Key is
+        // not valid if the iterator points after the end of the collection,
+        // or if the collection in question doesn't have keys, such as an
+        // array or list.
         //
 
-        virtual ~KeyValueIterator()
+        bool Key(const KeyType ** const key) const
         {
+            if (this->IsEnd())
+            {
+                return false;
+            }
+
+            *key = &this->m_iterator->first;
+            return true;
         }
+    };
+
+    //
+    // Holds the iterator a collection last returned from First or Find.
+    // Replacing it or destroying the slot lets go of the old iterator,
+    // which lives on if a variable owns it.
+    //
+
+    template<class Iterator>
+    class IteratorSlot
+    {
+    public:
+
+        IteratorSlot()
+            : m_iterator(nullptr)
+        {
+        }
+
+        ~IteratorSlot()
+        {
+            Reset(nullptr);
+        }
+
+        IteratorSlot(const IteratorSlot &) = delete;
+        const IteratorSlot &operator=(const IteratorSlot &) = delete;
 
         //
-        // Return the key under the current iterator through the key parameter.
-        // True is returned if key is valid and false if it is not.  Key is
-        // not valid if the iterator points after the end of the collection,
-        // or if the collection in question doesn't have keys, such as an
-        // array or list.
+        // Hold a new iterator, releasing the current one, and return it.
         //
 
-        virtual bool Key(const KeyType ** const key) const = 0;
+        template<class Derived>
+        Derived * Reset(std::unique_ptr<Derived> iterator)
+        {
+            if (m_iterator != nullptr)
+            {
+                m_iterator->Release(Iterator::HeldByCollection);
+            }
+
+            Derived * result = iterator.release();
+
+            m_iterator = result;
+            if (m_iterator != nullptr)
+            {
+                m_iterator->Take(Iterator::HeldByCollection);
+            }
+
+            return result;
+        }
+
+        Iterator * Reset(std::nullptr_t)
+        {
+            return Reset(std::unique_ptr<Iterator>());
+        }
+
+        Iterator * get() const
+        {
+            return m_iterator;
+        }
+
+    private:
+
+        Iterator * m_iterator;
     };
 
     //
@@ -229,13 +382,13 @@ namespace Collections
     // Clear		- Delete all elements in the collection
     // First		- Return an Iterator referencing the first element.
     //
+    // IteratorType is the concrete iterator of the collection, such as
+    // ListIterator.  It is made from the container, so First needs no
+    // virtual factory and returns the concrete type.
+    //
 
-    template<
-            typename coll,
-            typename ValueType = coll::value_type,
-            typename KeyType = ValueType,
-            typename IteratorType = IteratorBase<coll>>
-        class Collection
+    template<typename coll, typename IteratorType>
+    class Collection
     {
     public:
 
@@ -247,24 +400,11 @@ namespace Collections
         {
         }
 
-        //
-        // Delete the collection.
-        //
-
-        virtual ~Collection()
-        {
-            //
-            // Clear our container.
-            //
-
-            Clear();
-        }
-
         //
         // Return the count of elements in the collection.
         //
 
-        virtual size_t Count() const
+        size_t Count() const
         {
             return (size_t) m_coll.size();
         }
@@ -273,7 +413,7 @@ namespace Collections
         // Clear (delete all elements) in the collection.
         //
 
-        virtual void Clear()
+        void Clear()
         {
             m_coll.clear();
         }
@@ -283,21 +423,21 @@ namespace Collections
         // collection or an iterator for which IsEnd is true.
         //
 
-        virtual IteratorType * First()
+        IteratorType * First()
         {
-            m_iter = std::move(GetNewIterator(m_coll));
-
-            return m_iter.get();
+            return m_iter.Reset(std::make_unique<IteratorType>(m_coll));
         }
 
     protected:
 
         //
-        // Derived class must implement a method that creates a new Iterator
-        // appropriate to that class.
+        // A collection is only deleted as the concrete type that derives
+        // from it.
         //
 
-        virtual std::unique_ptr<IteratorType> GetNewIterator(const coll & refCollection) const = 0;
+        ~Collection()
+        {
+        }
 
         //
         // Container maintained by the collection.
@@ -309,6 +449,6 @@ namespace Collections
         // Iterator on the collection returned by First.
         //
 
-        std::unique_ptr<IteratorType> m_iter;
+        IteratorSlot<IteratorType> m_iter;
     };
 }  // namespace Collections
@@ -0,0 +1,201 @@
+//
+// Implementation file for the Collections top-level object.
+//
+
+#include <cstring>
+#include <iterator>
+#include <string>
+
+#include "ArgumentCache.h"
+#include "CollectionsInfo.h"
+#include "MemberDispatch.h"
+#include "Statistics.h"
+
+using namespace Collections;
+using namespace Diagnostics;
+
+//
+// Initialize the member name map.  Last entry must contain a null string
+// pointer.
+//
+
+constexpr MQTypeMember CollectionsInfo::CollectionsInfoMembers[] =
+{
+    { (DWORD) CollectionsInfoMembers::Stats, "Stats" },
+    { (DWORD) CollectionsInfoMembers::Calls, "Calls" },
+    { (DWORD) CollectionsInfoMembers::TotalTime, "TotalTime" },
+    { (DWORD) CollectionsInfoMembers::P50, "P50" },
+    { (DWORD) CollectionsInfoMembers::P99, "P99" },
+    { (DWORD) CollectionsInfoMembers::MaxTime, "MaxTime" },
+    { (DWORD) CollectionsInfoMembers::HighWater, "HighWater" },
+    { (DWORD) CollectionsInfoMembers::CacheHits, "CacheHits" },
+    { (DWORD) CollectionsInfoMembers::CacheMisses, "CacheMisses" },
+    { 0, 0 }
+};
+
+//
+// Return the member table that names the members to MQ2.
+//
+
+const MQTypeMember * CollectionsInfo::GetMembers()
+{
+    return CollectionsInfoMembers;
+}
+
+//
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
+//
+
+const MQTypeMember * CollectionsInfo::LookupMember(const char * Name)
+{
+    static constexpr Types::MemberDispatch<std::size(CollectionsInfoMembers)> dispatch(CollectionsInfoMembers);
+
+    return dispatch.Find(Name);
+}
+
+//
+// When a member function is called on the type, this method is called.
+// It returns true if the method succeeded and false otherwise.
+//
+
+bool CollectionsInfo::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+{
+    Statistics::MemberStatistics statistics;
+
+    //
+    // Default return value is FALSE.
+    //
+
+    Dest.Int = 0;
+    Dest.Type = mq::datatypes::pBoolType;
+
+    //
+    // Map the member name to the id.
+    //
+
+    auto pMember = LookupMember(Member);
+    if (pMember == nullptr)
+    {
+        //
+        // No such member.
+        //
+
+        return false;
+    }
+
+    auto memberId = (enum class CollectionsInfoMembers) pMember->ID;
+
+    switch (memberId)
+    {
+        case CollectionsInfoMembers::Stats:
+            //
+            // Are statistics being gathered?
+            //
+
+            Dest.Int = Statistics::Enabled() ? 1 : 0;
+            return true;
+
+        case CollectionsInfoMembers::HighWater:
+            //
+            // Largest collection of a type seen.
+            //
+
+            if (!NOT_EMPTY(Index))
+            {
+                return false;
+            }
+
+            Dest.Int64 = (int64_t) Statistics::HighWaterMark(Index);
+            Dest.Type = mq::datatypes::pInt64Type;
+            return true;
+
+        case CollectionsInfoMembers::CacheHits:
+            //
+            // Member arguments found already split.
+            //
+
+            Dest.Int64 = (int64_t) ArgumentCache::Hits();
+            Dest.Type = mq::datatypes::pInt64Type;
+            return true;
+
+        case CollectionsInfoMembers::CacheMisses:
+            //
+            // Member arguments that had to be split.
+            //
+
+            Dest.Int64 = (int64_t) ArgumentCache::Misses();
+            Dest.Type = mq::datatypes::pInt64Type;
+            return true;
+
+        default:
+            break;
+    }
+
+    //
+    // The remaining members take a type.member index.
+    //
+
+    const char * separator = NOT_EMPTY(Index) ? std::strchr(Index, '.') : nullptr;
+    if (separator == nullptr)
+    {
+        return false;
+    }
+
+    std::string typeName(Index, separator - Index);
+
+    if (!Statistics::Find(typeName.c_str(), separator + 1, statistics))
+    {
+        //
+        // The member hasn't been called.
+        //
+
+        statistics = Statistics::MemberStatistics { nullptr, nullptr, 0, 0, 0, 0, 0 };
+    }
+
+    Dest.Type = mq::datatypes::pInt64Type;
+
+    switch (memberId)
+    {
+        case CollectionsInfoMembers::Calls:
+            Dest.Int64 = (int64_t) statistics.Calls;
+            break;
+
+        case CollectionsInfoMembers::TotalTime:
+            Dest.Int64 = (int64_t) statistics.TotalNanoseconds;
+            break;
+
+        case CollectionsInfoMembers::P50:
+            Dest.Int64 = (int64_t) statistics.P50Nanoseconds;
+            break;
+
+        case CollectionsInfoMembers::P99:
+            Dest.Int64 = (int64_t) statistics.P99Nanoseconds;
+            break;
+
+        case CollectionsInfoMembers::MaxTime:
+            Dest.Int64 = (int64_t) statistics.MaxNanoseconds;
+            break;
+
+        default:
+            //
+            // Unknown member!
+            //
+
+            Dest.Int = 0;
+            Dest.Type = mq::datatypes::pBoolType;
+            return false;
+    }
+
+    return true;
+}
+
+//
+// Convert the object to a string -- output whether statistics are being
+// gathered.
+//
+
+bool CollectionsInfo::ToString(MQVarPtr VarPtr, PCHAR Destination)
+{
+    return strcpy_s(Destination, BUFFER_SIZE, Statistics::Enabled() ? "TRUE" : "FALSE") == 0;
+}
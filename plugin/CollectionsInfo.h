@@ -0,0 +1,120 @@
+//
+// CollectionsInfo - the Collections top-level object, which reports the
+// statistics gathered on the collection types.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include "Types.h"
+
+using namespace Types;
+
+namespace Diagnostics
+{
+    //
+    // ${Collections} reports the statistics gathered while
+    // /collections stats on is in effect.  Members taking an index expect
+    // "type.member", for example ${Collections.P99[list.Item]}; HighWater
+    // takes a type name.  Times are in nanoseconds.
+    //
+
+    class CollectionsInfo : public BaseType<CollectionsInfo>
+    {
+    public:
+
+        //
+        // MQ2Type Members
+        //
+
+        enum class CollectionsInfoMembers
+        {
+            Stats = 1,
+            Calls,
+            TotalTime,
+            P50,
+            P99,
+            MaxTime,
+            HighWater,
+            CacheHits,
+            CacheMisses
+        };
+
+        //
+        // Constructor.
+        //
+
+        CollectionsInfo()
+        {
+        }
+
+        //
+        // Destructor.
+        //
+
+        ~CollectionsInfo()
+        {
+        }
+
+        //
+        // Don't permit copy construction and assignment since the MQ2Type does
+        // implement them.
+        //
+
+        CollectionsInfo(const CollectionsInfo &) = delete;
+        const CollectionsInfo &operator=(const CollectionsInfo &) = delete;
+
+        //
+        // Return the name of this type - Collections.
+        //
+
+        static const char *GetTypeName()
+        {
+            return "Collections";
+        }
+
+        //
+        // The type is a single top-level object that is never deleted.
+        //
+
+        bool CanDelete() const
+        {
+            return false;
+        }
+
+        //
+        // Return the member table that names the members to MQ2.
+        //
+
+        static const MQTypeMember * GetMembers();
+
+        //
+        // Return the member table entry for a member name or null if there
+        // is no such member.
+        //
+
+        static const MQTypeMember * LookupMember(const char * Name);
+
+        //
+        // When a member function is called on the type, this method is called.
+        // It returns true if the method succeeded and false otherwise.
+        //
+
+        static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
+
+        //
+        // Convert the object to a string -- output whether statistics are
+        // being gathered.
+        //
+
+        static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+
+    private:
+
+        //
+        // Map from member ids onto names.
+        //
+
+        static const MQTypeMember CollectionsInfoMembers[];
+    };
+}  // namespace Diagnostics
@@ -6,66 +6,211 @@
 
 #include "DebugMemory.h"
 
-#include <cstdlib>
+#include <cstddef>
 #include <cstdint>
 #include <cerrno>
+#include <type_traits>
 
 namespace Conversions
 {
-    //
-    // Specialization for longs. Delegate to _ltoa_s for implementation.
-    //
-
-    template<size_t size>
-    inline errno_t ValueToString(long value, char(&buffer)[size], uint16_t radix)
+    namespace Details
     {
-        // Radix must be 2 <= radix <= 36 or an error is returned.
-        return _ltoa_s(value, temp_buffer, (int) radix);
-    }
+        //
+        // Characters for each digit value up to radix 36.
+        //
 
-    //
-    // Specialization for unsigned longs. Delegate to _ltoa_s for implementation.
-    //
+        constexpr char Digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
 
-    template<size_t size>
-    inline errno_t ValueToString(unsigned int value, char(&buffer)[size], uint16_t radix)
-    {
-        return ValueToString((size_t) value, buffer, radix);
-    }
+        //
+        // The two characters of each value from 00 to 99, so that decimal
+        // numbers are formatted two digits per division.
+        //
 
-    //
-    // Specialization for unsigned int. Delegate to _ltoa_s for implementation.
-    //
+        constexpr char DigitPairs[] =
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
 
-    template<size_t size>
-    inline errno_t ValueToString(size_t value, char(&buffer)[size], uint16_t radix)
-    {
-        // Radix must be 2 <= radix <= 36 or an error is returned.
-        return _ultoa_s((unsigned long)value, buffer, (int) radix);
-    }
+        //
+        // Return the number of digits needed to write value in radix.
+        //
+
+        template<typename U>
+        inline size_t DigitCount(U value, unsigned radix)
+        {
+            size_t count = 1;
+
+            if (radix == 10)
+            {
+                //
+                // Compare against powers of ten, dividing once for every
+                // four digits.
+                //
+
+                for (;;)
+                {
+                    if (value < 10U)
+                    {
+                        return count;
+                    }
+
+                    if (value < 100U)
+                    {
+                        return count + 1;
+                    }
+
+                    if (value < 1000U)
+                    {
+                        return count + 2;
+                    }
+
+                    if (value < 10000U)
+                    {
+                        return count + 3;
+                    }
+
+                    value /= 10000U;
+                    count += 4;
+                }
+            }
+
+            while (value >= radix)
+            {
+                value /= radix;
+                ++count;
+            }
+
+            return count;
+        }
+
+        //
+        // Write the digits of value in radix so that the last one is just
+        // before end.
+        //
+
+        template<typename U>
+        inline void WriteDigits(U value, char * end, unsigned radix)
+        {
+            if (radix == 10)
+            {
+                while (value >= 100U)
+                {
+                    size_t pair = (size_t) (value % 100U) * 2;
+
+                    value /= 100U;
+                    *--end = DigitPairs[pair + 1];
+                    *--end = DigitPairs[pair];
+                }
+
+                if (value >= 10U)
+                {
+                    size_t pair = (size_t) value * 2;
+
+                    *--end = DigitPairs[pair + 1];
+                    *--end = DigitPairs[pair];
+                }
+                else
+                {
+                    *--end = (char) ('0' + value);
+                }
+
+                return;
+            }
+
+            if ((radix & (radix - 1)) == 0)
+            {
+                //
+                // A power of two radix: shift and mask instead of dividing.
+                //
+
+                unsigned shift = 0;
+
+                while ((1U << shift) != radix)
+                {
+                    ++shift;
+                }
+
+                do
+                {
+                    *--end = Digits[(size_t) (value & (radix - 1))];
+                    value >>= shift;
+                } while (value != 0);
+
+                return;
+            }
+
+            do
+            {
+                *--end = Digits[(size_t) (value % radix)];
+                value /= radix;
+            } while (value != 0);
+        }
+    }  // namespace Details
 
     //
-    // Convert a scalar value to an ASCII string.
+    // Convert an integral value to an ASCII string, writing it directly into
+    // buffer.  Like _ltoa_s, a negative value has a minus sign in radix 10
+    // and is written as its unsigned two's complement in any other radix.
     //
     // Returns
     //    0                     Successful completion.
     //    EINVAL                Invalid argument
     //    ERANGE                The output buffer is too short to contain the
     //                          result string.
+    //
+    // On failure buffer holds an empty string if it has any room at all.
+    //
 
     template<typename T>
     inline errno_t ToString(T value, char * buffer, size_t buff_size, uint16_t radix = 10)
     {
-        char temp_buffer[_MAX_PATH];        // More than enough for any scalar.
-        errno_t rc;
+        static_assert(std::is_integral<T>::value && !std::is_same<T, bool>::value,
+                      "ToString requires an integral type.");
+
+        using Unsigned = typename std::make_unsigned<T>::type;
+
+        if ((buffer == nullptr) || (buff_size == 0))
+        {
+            return EINVAL;
+        }
 
         // Radix must be 2 <= radix <= 36.
-        rc = ValueToString(value, temp_buffer, radix);
-        if (rc == 0)
+        if ((radix < 2) || (radix > 36))
+        {
+            buffer[0] = '\0';
+            return EINVAL;
+        }
+
+        Unsigned magnitude = (Unsigned) value;
+        bool negative = false;
+
+        if constexpr (std::is_signed<T>::value)
+        {
+            if ((value < 0) && (radix == 10))
+            {
+                negative = true;
+                magnitude = (Unsigned) (Unsigned(0) - magnitude);
+            }
+        }
+
+        size_t length = Details::DigitCount(magnitude, radix) + (negative ? 1 : 0);
+
+        if (length >= buff_size)
+        {
+            buffer[0] = '\0';
+            return ERANGE;
+        }
+
+        buffer[length] = '\0';
+        Details::WriteDigits(magnitude, buffer + length, radix);
+
+        if (negative)
         {
-            rc = strcpy_s(buffer, buff_size, temp_buffer);
+            buffer[0] = '-';
         }
 
-        return rc;
+        return 0;
     }
 }
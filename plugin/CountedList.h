@@ -0,0 +1,856 @@
+//
+// CountedList.h
+//
+// A sequence with the interface of std::list that also finds the item at a
+// position, and the position of an item, in O(log n).
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Collections
+{
+    namespace Containers
+    {
+        //
+        // The items are the nodes of an AVL tree kept in sequence order.  Each
+        // node counts the nodes below it, so the item at a position is found
+        // by walking down from the root, and inserting or erasing at a
+        // position is O(log n).  The nodes are also threaded in order through
+        // a circular list whose header is end(), so iterating costs what it
+        // does on std::list.
+        //
+        // As with std::list, a node is never moved or copied once it is made.
+        // Inserting or erasing, sort and reverse leave iterators to the other
+        // items valid, which the iterators a macro keeps in a variable rely
+        // on.
+        //
+
+        template <typename T>
+        class CountedList
+        {
+            struct NodeBase
+            {
+                NodeBase * Parent;
+                NodeBase * Left;
+                NodeBase * Right;
+                NodeBase * Previous;
+                NodeBase * Next;
+                uint32_t Count;
+                int32_t Height;
+            };
+
+            struct Node : NodeBase
+            {
+                template <typename... Args>
+                explicit Node(Args &&... args)
+                    : NodeBase(),
+                      Value(std::forward<Args>(args)...)
+                {
+                }
+
+                T Value;
+            };
+
+            template <bool IsConst>
+            class Iterator
+            {
+            public:
+
+                typedef std::bidirectional_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef typename std::conditional<IsConst, const T *, T *>::type pointer;
+                typedef typename std::conditional<IsConst, const T &, T &>::type reference;
+
+                Iterator()
+                    : m_node(nullptr)
+                {
+                }
+
+                //
+                // An iterator converts to a const_iterator.
+                //
+
+                Iterator(const Iterator<false> & other)
+                    : m_node(other.m_node)
+                {
+                }
+
+                reference operator*() const
+                {
+                    return static_cast<Node *>(m_node)->Value;
+                }
+
+                pointer operator->() const
+                {
+                    return &static_cast<Node *>(m_node)->Value;
+                }
+
+                Iterator & operator++()
+                {
+                    m_node = m_node->Next;
+                    return *this;
+                }
+
+                Iterator operator++(int)
+                {
+                    Iterator previous(*this);
+
+                    m_node = m_node->Next;
+                    return previous;
+                }
+
+                Iterator & operator--()
+                {
+                    m_node = m_node->Previous;
+                    return *this;
+                }
+
+                Iterator operator--(int)
+                {
+                    Iterator previous(*this);
+
+                    m_node = m_node->Previous;
+                    return previous;
+                }
+
+                friend bool operator==(const Iterator & left, const Iterator & right)
+                {
+                    return left.m_node == right.m_node;
+                }
+
+                friend bool operator!=(const Iterator & left, const Iterator & right)
+                {
+                    return left.m_node != right.m_node;
+                }
+
+            private:
+
+                friend class CountedList;
+                template <bool> friend class Iterator;
+
+                explicit Iterator(NodeBase * node)
+                    : m_node(node)
+                {
+                }
+
+                NodeBase * m_node;
+            };
+
+        public:
+
+            typedef T value_type;
+            typedef size_t size_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef T & reference;
+            typedef const T & const_reference;
+            typedef Iterator<false> iterator;
+            typedef Iterator<true> const_iterator;
+
+            CountedList()
+            {
+                Initialize();
+            }
+
+            template <typename InputIterator>
+            CountedList(InputIterator first, InputIterator last)
+            {
+                Initialize();
+                assign(first, last);
+            }
+
+            CountedList(const CountedList & other)
+            {
+                Initialize();
+                assign(other.cbegin(), other.cend());
+            }
+
+            CountedList & operator=(const CountedList & other)
+            {
+                if (this != &other)
+                {
+                    assign(other.cbegin(), other.cend());
+                }
+
+                return *this;
+            }
+
+            ~CountedList()
+            {
+                clear();
+            }
+
+            //
+            // Replace the items with copies of [first, last).
+            //
+
+            template <typename InputIterator>
+            void assign(InputIterator first, InputIterator last)
+            {
+                std::vector<NodeBase *> nodes;
+
+                clear();
+
+                try
+                {
+                    for (; first != last; ++first)
+                    {
+                        nodes.push_back(new Node(*first));
+                    }
+                }
+                catch (...)
+                {
+                    for (auto node : nodes)
+                    {
+                        delete static_cast<Node *>(node);
+                    }
+
+                    throw;
+                }
+
+                Build(nodes);
+            }
+
+            size_t size() const
+            {
+                return CountOf(m_root);
+            }
+
+            bool empty() const
+            {
+                return m_root == nullptr;
+            }
+
+            iterator begin()
+            {
+                return iterator(m_header.Next);
+            }
+
+            const_iterator begin() const
+            {
+                return cbegin();
+            }
+
+            const_iterator cbegin() const
+            {
+                return const_iterator(m_header.Next);
+            }
+
+            iterator end()
+            {
+                return iterator(&m_header);
+            }
+
+            const_iterator end() const
+            {
+                return cend();
+            }
+
+            const_iterator cend() const
+            {
+                return const_iterator(const_cast<NodeBase *>(&m_header));
+            }
+
+            T & front()
+            {
+                return *begin();
+            }
+
+            const T & front() const
+            {
+                return *cbegin();
+            }
+
+            T & back()
+            {
+                return static_cast<Node *>(m_header.Previous)->Value;
+            }
+
+            const T & back() const
+            {
+                return static_cast<const Node *>(m_header.Previous)->Value;
+            }
+
+            //
+            // Return an iterator to the item at position or end() if
+            // position is past the last item.
+            //
+
+            iterator nth(size_t position)
+            {
+                return iterator(Find(position));
+            }
+
+            const_iterator nth(size_t position) const
+            {
+                return const_iterator(Find(position));
+            }
+
+            //
+            // Return the position of the item under an iterator, or size()
+            // for end().
+            //
+
+            size_t index_of(const_iterator position) const
+            {
+                const NodeBase * node = position.m_node;
+
+                if (node == &m_header)
+                {
+                    return size();
+                }
+
+                size_t index = CountOf(node->Left);
+
+                for (; node->Parent != nullptr; node = node->Parent)
+                {
+                    if (node == node->Parent->Right)
+                    {
+                        index += CountOf(node->Parent->Left) + 1;
+                    }
+                }
+
+                return index;
+            }
+
+            //
+            // Insert an item made from args before position and return an
+            // iterator to it.
+            //
+
+            template <typename... Args>
+            iterator emplace(const_iterator position, Args &&... args)
+            {
+                NodeBase * node = new Node(std::forward<Args>(args)...);
+
+                Link(node, position.m_node);
+                return iterator(node);
+            }
+
+            iterator insert(const_iterator position, const T & value)
+            {
+                return emplace(position, value);
+            }
+
+            iterator insert(const_iterator position, T && value)
+            {
+                return emplace(position, std::move(value));
+            }
+
+            //
+            // Insert copies of [first, last) before position and return an
+            // iterator to the first one, or position if the range is empty.
+            //
+
+            template <typename InputIterator>
+            iterator insert(const_iterator position, InputIterator first, InputIterator last)
+            {
+                iterator result(position.m_node);
+                bool inserted = false;
+
+                for (; first != last; ++first)
+                {
+                    auto item = emplace(position, *first);
+
+                    if (!inserted)
+                    {
+                        result = item;
+                        inserted = true;
+                    }
+                }
+
+                return result;
+            }
+
+            template <typename... Args>
+            T & emplace_back(Args &&... args)
+            {
+                return *emplace(cend(), std::forward<Args>(args)...);
+            }
+
+            void push_back(const T & value)
+            {
+                emplace(cend(), value);
+            }
+
+            void push_back(T && value)
+            {
+                emplace(cend(), std::move(value));
+            }
+
+            void push_front(const T & value)
+            {
+                emplace(cbegin(), value);
+            }
+
+            void pop_front()
+            {
+                erase(cbegin());
+            }
+
+            void pop_back()
+            {
+                erase(const_iterator(m_header.Previous));
+            }
+
+            //
+            // Erase the item under position and return an iterator to the
+            // item after it.
+            //
+
+            iterator erase(const_iterator position)
+            {
+                NodeBase * node = position.m_node;
+                NodeBase * next = node->Next;
+
+                Unlink(node);
+                delete static_cast<Node *>(node);
+
+                return iterator(next);
+            }
+
+            //
+            // Erase every item for which predicate is true and return how
+            // many were erased.
+            //
+
+            template <typename Predicate>
+            size_t remove_if(Predicate predicate)
+            {
+                std::vector<NodeBase *> erased;
+
+                for (NodeBase * node = m_header.Next; node != &m_header; node = node->Next)
+                {
+                    if (predicate(static_cast<Node *>(node)->Value))
+                    {
+                        erased.push_back(node);
+                    }
+                }
+
+                //
+                // Unlink a few nodes one at a time.  When there are many,
+                // rebuild the tree from the rest instead, marking the erased
+                // nodes with a height of zero.
+                //
+
+                if (erased.size() * RebuildRatio < size())
+                {
+                    for (auto node : erased)
+                    {
+                        Unlink(node);
+                    }
+                }
+                else if (!erased.empty())
+                {
+                    for (auto node : erased)
+                    {
+                        node->Height = 0;
+                    }
+
+                    std::vector<NodeBase *> kept;
+
+                    kept.reserve(size() - erased.size());
+
+                    for (NodeBase * node = m_header.Next; node != &m_header; node = node->Next)
+                    {
+                        if (node->Height != 0)
+                        {
+                            kept.push_back(node);
+                        }
+                    }
+
+                    Build(kept);
+                }
+
+                for (auto node : erased)
+                {
+                    delete static_cast<Node *>(node);
+                }
+
+                return erased.size();
+            }
+
+            //
+            // Sort the items into ascending order, keeping equal items in
+            // the order they were in.
+            //
+
+            void sort()
+            {
+                auto nodes = Nodes();
+
+                std::stable_sort(nodes.begin(),
+                                 nodes.end(),
+                                 [] (const NodeBase * left, const NodeBase * right)
+                                 {
+                                     return static_cast<const Node *>(left)->Value < static_cast<const Node *>(right)->Value;
+                                 });
+
+                Build(nodes);
+            }
+
+            void reverse()
+            {
+                auto nodes = Nodes();
+
+                std::reverse(nodes.begin(), nodes.end());
+                Build(nodes);
+            }
+
+            void clear()
+            {
+                NodeBase * node = m_header.Next;
+
+                while (node != &m_header)
+                {
+                    NodeBase * next = node->Next;
+
+                    delete static_cast<Node *>(node);
+                    node = next;
+                }
+
+                Initialize();
+            }
+
+        private:
+
+            //
+            // remove_if rebuilds the tree rather than unlinking each node
+            // when at least one node in RebuildRatio is erased.
+            //
+
+            static const size_t RebuildRatio = 16;
+
+            void Initialize()
+            {
+                m_header = NodeBase();
+                m_header.Previous = &m_header;
+                m_header.Next = &m_header;
+                m_root = nullptr;
+            }
+
+            static size_t CountOf(const NodeBase * node)
+            {
+                return (node != nullptr) ? node->Count : 0;
+            }
+
+            static int HeightOf(const NodeBase * node)
+            {
+                return (node != nullptr) ? node->Height : 0;
+            }
+
+            static void Update(NodeBase * node)
+            {
+                node->Count = (uint32_t) (CountOf(node->Left) + CountOf(node->Right) + 1);
+                node->Height = std::max(HeightOf(node->Left), HeightOf(node->Right)) + 1;
+            }
+
+            //
+            // Return the node at position or the header if there is none.
+            //
+
+            NodeBase * Find(size_t position) const
+            {
+                NodeBase * node = m_root;
+
+                while (node != nullptr)
+                {
+                    size_t left = CountOf(node->Left);
+
+                    if (position < left)
+                    {
+                        node = node->Left;
+                    }
+                    else if (position == left)
+                    {
+                        return node;
+                    }
+                    else
+                    {
+                        position -= left + 1;
+                        node = node->Right;
+                    }
+                }
+
+                return const_cast<NodeBase *>(&m_header);
+            }
+
+            //
+            // Return the nodes in sequence order.
+            //
+
+            std::vector<NodeBase *> Nodes() const
+            {
+                std::vector<NodeBase *> nodes;
+
+                nodes.reserve(size());
+
+                for (NodeBase * node = m_header.Next; node != &m_header; node = node->Next)
+                {
+                    nodes.push_back(node);
+                }
+
+                return nodes;
+            }
+
+            //
+            // Make the tree and the thread hold nodes in order.
+            //
+
+            void Build(const std::vector<NodeBase *> & nodes)
+            {
+                NodeBase * previous = &m_header;
+
+                for (auto node : nodes)
+                {
+                    previous->Next = node;
+                    node->Previous = previous;
+                    previous = node;
+                }
+
+                previous->Next = &m_header;
+                m_header.Previous = previous;
+
+                m_root = Build(nodes, 0, nodes.size(), nullptr);
+            }
+
+            static NodeBase * Build(const std::vector<NodeBase *> & nodes, size_t first, size_t last, NodeBase * parent)
+            {
+                if (first == last)
+                {
+                    return nullptr;
+                }
+
+                size_t middle = first + (last - first) / 2;
+                NodeBase * node = nodes[middle];
+
+                node->Parent = parent;
+                node->Left = Build(nodes, first, middle, node);
+                node->Right = Build(nodes, middle + 1, last, node);
+                Update(node);
+
+                return node;
+            }
+
+            //
+            // Point the parent of child at replacement instead.
+            //
+
+            void Replace(NodeBase * parent, NodeBase * child, NodeBase * replacement)
+            {
+                if (parent == nullptr)
+                {
+                    m_root = replacement;
+                }
+                else if (parent->Left == child)
+                {
+                    parent->Left = replacement;
+                }
+                else
+                {
+                    parent->Right = replacement;
+                }
+            }
+
+            NodeBase * RotateLeft(NodeBase * node)
+            {
+                NodeBase * right = node->Right;
+
+                node->Right = right->Left;
+                if (right->Left != nullptr)
+                {
+                    right->Left->Parent = node;
+                }
+
+                right->Parent = node->Parent;
+                Replace(node->Parent, node, right);
+
+                right->Left = node;
+                node->Parent = right;
+
+                Update(node);
+                Update(right);
+
+                return right;
+            }
+
+            NodeBase * RotateRight(NodeBase * node)
+            {
+                NodeBase * left = node->Left;
+
+                node->Left = left->Right;
+                if (left->Right != nullptr)
+                {
+                    left->Right->Parent = node;
+                }
+
+                left->Parent = node->Parent;
+                Replace(node->Parent, node, left);
+
+                left->Right = node;
+                node->Parent = left;
+
+                Update(node);
+                Update(left);
+
+                return left;
+            }
+
+            //
+            // Recount and rebalance from node up to the root.
+            //
+
+            void Rebalance(NodeBase * node)
+            {
+                while (node != nullptr)
+                {
+                    Update(node);
+
+                    int balance = HeightOf(node->Left) - HeightOf(node->Right);
+
+                    if (balance > 1)
+                    {
+                        if (HeightOf(node->Left->Left) < HeightOf(node->Left->Right))
+                        {
+                            RotateLeft(node->Left);
+                        }
+
+                        node = RotateRight(node);
+                    }
+                    else if (balance < -1)
+                    {
+                        if (HeightOf(node->Right->Right) < HeightOf(node->Right->Left))
+                        {
+                            RotateRight(node->Right);
+                        }
+
+                        node = RotateLeft(node);
+                    }
+
+                    node = node->Parent;
+                }
+            }
+
+            //
+            // Add a new node before position.
+            //
+
+            void Link(NodeBase * node, NodeBase * position)
+            {
+                node->Left = nullptr;
+                node->Right = nullptr;
+                node->Count = 1;
+                node->Height = 1;
+
+                node->Next = position;
+                node->Previous = position->Previous;
+                position->Previous->Next = node;
+                position->Previous = node;
+
+                //
+                // The node goes at the bottom of the tree, as the left child
+                // of position or else as the right child of the node before
+                // it, which is the rightmost node of position's left subtree
+                // or the last node.
+                //
+
+                if (m_root == nullptr)
+                {
+                    node->Parent = nullptr;
+                    m_root = node;
+                    return;
+                }
+
+                if ((position != &m_header) && (position->Left == nullptr))
+                {
+                    position->Left = node;
+                    node->Parent = position;
+                }
+                else
+                {
+                    node->Previous->Right = node;
+                    node->Parent = node->Previous;
+                }
+
+                Rebalance(node->Parent);
+            }
+
+            //
+            // Take a node out of the thread and the tree.
+            //
+
+            void Unlink(NodeBase * node)
+            {
+                NodeBase * start;
+
+                node->Previous->Next = node->Next;
+                node->Next->Previous = node->Previous;
+
+                if ((node->Left == nullptr) || (node->Right == nullptr))
+                {
+                    NodeBase * child = (node->Left != nullptr) ? node->Left : node->Right;
+
+                    if (child != nullptr)
+                    {
+                        child->Parent = node->Parent;
+                    }
+
+                    Replace(node->Parent, node, child);
+                    start = node->Parent;
+                }
+                else
+                {
+                    //
+                    // Move the next node, the leftmost of the right subtree,
+                    // into the erased node's place.
+                    //
+
+                    NodeBase * next = node->Next;
+
+                    if (next->Parent != node)
+                    {
+                        start = next->Parent;
+
+                        next->Parent->Left = next->Right;
+                        if (next->Right != nullptr)
+                        {
+                            next->Right->Parent = next->Parent;
+                        }
+
+                        next->Right = node->Right;
+                        node->Right->Parent = next;
+                    }
+                    else
+                    {
+                        start = next;
+                    }
+
+                    next->Left = node->Left;
+                    node->Left->Parent = next;
+
+                    next->Parent = node->Parent;
+                    Replace(node->Parent, node, next);
+                }
+
+                Rebalance(start);
+            }
+
+            //
+            // The header of the thread: Next is the first node, Previous the
+            // last, and the header itself is end().
+            //
+
+            NodeBase m_header;
+            NodeBase * m_root;
+        };
+    }  // namespace Containers
+}  // namespace Collections
@@ -0,0 +1,246 @@
+//
+// DelimiterScanner.h
+//
+// Find the next of a set of characters in a run of text, a block of 16 or
+// 32 bytes at a time where the compiler targets SSE2 or AVX2 and a byte at a
+// time through a 256 entry bitmap otherwise.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(MQ2COLLECTIONS_SCALAR_SCAN)
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define MQ2COLLECTIONS_SCAN_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define MQ2COLLECTIONS_SCAN_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Extensions
+{
+    namespace Strings
+    {
+        //
+        // A set of characters to scan for, built once for a delimiter set
+        // and used for every character of the text being split.
+        //
+        // The vector scan compares each block with every character of the
+        // set, so it is used only for sets of up to MaximumVectorCharacters
+        // distinct characters.  Larger sets scan through the bitmap.
+        //
+
+        class DelimiterScanner
+        {
+        public:
+
+            static const size_t MaximumVectorCharacters = 8;
+
+            //
+            // Scan for any of count characters.
+            //
+
+            DelimiterScanner(const char * characters, size_t count)
+                : m_bitmap { 0, 0, 0, 0 },
+                  m_count(0)
+            {
+                Add(characters, count);
+            }
+
+            //
+            // Add count characters to the set.
+            //
+
+            void Add(const char * characters, size_t count)
+            {
+                for (size_t index = 0; index < count; ++index)
+                {
+                    auto c = (unsigned char) characters[index];
+
+                    if (Contains((char) c))
+                    {
+                        continue;
+                    }
+
+                    m_bitmap[c >> 6] |= (uint64_t) 1 << (c & 63);
+
+                    if (m_count < MaximumVectorCharacters)
+                    {
+                        m_characters[m_count] = (char) c;
+                    }
+
+                    ++m_count;
+                }
+            }
+
+            //
+            // Return true if c is in the set.
+            //
+
+            bool Contains(char c) const
+            {
+                auto u = (unsigned char) c;
+
+                return ((m_bitmap[u >> 6] >> (u & 63)) & 1) != 0;
+            }
+
+            //
+            // Return a pointer to the first character in [first, last) that
+            // is in the set or last if there is none.
+            //
+
+            const char * Find(const char * first, const char * last) const
+            {
+                if (m_count <= MaximumVectorCharacters)
+                {
+#if defined(MQ2COLLECTIONS_SCAN_AVX2)
+                    first = FindBlocks32(first, last);
+                    if (first != last && Contains(*first))
+                    {
+                        return first;
+                    }
+#endif
+
+#if defined(MQ2COLLECTIONS_SCAN_SSE2)
+                    first = FindBlocks16(first, last);
+#endif
+                }
+
+                return FindScalar(first, last);
+            }
+
+        private:
+
+            //
+            // Scan the rest of the text a byte at a time.
+            //
+
+            const char * FindScalar(const char * first, const char * last) const
+            {
+                while ((first != last) && !Contains(*first))
+                {
+                    ++first;
+                }
+
+                return first;
+            }
+
+            //
+            // Return the index of the lowest set bit of a non-zero mask.
+            //
+
+            static unsigned int LowestBit(uint32_t mask)
+            {
+#if defined(_MSC_VER)
+                unsigned long index;
+
+                _BitScanForward(&index, mask);
+                return (unsigned int) index;
+#else
+                return (unsigned int) __builtin_ctz(mask);
+#endif
+            }
+
+#if defined(MQ2COLLECTIONS_SCAN_SSE2)
+            //
+            // Scan whole 16 byte blocks.  Return the match if one is found,
+            // otherwise the start of the bytes left over after the last
+            // whole block.
+            //
+
+            const char * FindBlocks16(const char * first, const char * last) const
+            {
+                __m128i sets[MaximumVectorCharacters];
+
+                for (size_t index = 0; index < m_count; ++index)
+                {
+                    sets[index] = _mm_set1_epi8(m_characters[index]);
+                }
+
+                while (last - first >= 16)
+                {
+                    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(first));
+                    __m128i matches = _mm_setzero_si128();
+
+                    for (size_t index = 0; index < m_count; ++index)
+                    {
+                        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, sets[index]));
+                    }
+
+                    uint32_t mask = (uint32_t) _mm_movemask_epi8(matches);
+                    if (mask != 0)
+                    {
+                        return first + LowestBit(mask);
+                    }
+
+                    first += 16;
+                }
+
+                return first;
+            }
+#endif
+
+#if defined(MQ2COLLECTIONS_SCAN_AVX2)
+            //
+            // As FindBlocks16, 32 bytes at a time.
+            //
+
+            const char * FindBlocks32(const char * first, const char * last) const
+            {
+                __m256i sets[MaximumVectorCharacters];
+
+                for (size_t index = 0; index < m_count; ++index)
+                {
+                    sets[index] = _mm256_set1_epi8(m_characters[index]);
+                }
+
+                while (last - first >= 32)
+                {
+                    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+                    __m256i matches = _mm256_setzero_si256();
+
+                    for (size_t index = 0; index < m_count; ++index)
+                    {
+                        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, sets[index]));
+                    }
+
+                    uint32_t mask = (uint32_t) _mm256_movemask_epi8(matches);
+                    if (mask != 0)
+                    {
+                        return first + LowestBit(mask);
+                    }
+
+                    first += 32;
+                }
+
+                return first;
+            }
+#endif
+
+            //
+            // One bit for each byte value in the set.
+            //
+
+            uint64_t m_bitmap[4];
+
+            //
+            // The first MaximumVectorCharacters distinct characters and the
+            // number of distinct characters in the set.
+            //
+
+            char m_characters[MaximumVectorCharacters];
+            size_t m_count;
+        };
+    }  // namespace Strings
+}  // namespace Extensions
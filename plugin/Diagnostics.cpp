@@ -0,0 +1,13 @@
+//
+// Allocate the diagnostic feature switches.
+//
+
+#include "Diagnostics.h"
+
+using namespace Diagnostics;
+
+//
+// All features start switched off.
+//
+
+uint32_t Instrumentation::features = 0;
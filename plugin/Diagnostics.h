@@ -0,0 +1,142 @@
+//
+// Diagnostics.h
+//
+// Track which of the diagnostic features are switched on.  BaseType checks
+// Active() on every member call and only takes the instrumented path when
+// at least one feature is enabled.
+//
+// OperationScope applies the features that measure an operation while it
+// runs: allocation accounting and the Chrome trace timeline.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include "AllocationAccounting.h"
+#include "ChromeTrace.h"
+
+namespace Diagnostics
+{
+    class Instrumentation
+    {
+    public:
+
+        enum Feature : uint32_t
+        {
+            Trace = 0x01,
+            Allocations = 0x02,
+            Statistics = 0x04,
+            Timeline = 0x08
+        };
+
+        //
+        // Return true if any feature is enabled.
+        //
+
+        static bool Active()
+        {
+            return features != 0;
+        }
+
+        //
+        // Return true if a feature is enabled.
+        //
+
+        static bool Enabled(Feature feature)
+        {
+            return (features & feature) != 0;
+        }
+
+        //
+        // Switch a feature on or off.
+        //
+
+        static void Enable(Feature feature, bool enable)
+        {
+            if (enable)
+            {
+                features |= feature;
+            }
+            else
+            {
+                features &= ~(uint32_t) feature;
+            }
+        }
+
+    private:
+
+        //
+        // Combination of the enabled Features.
+        //
+
+        static uint32_t features;
+    };
+
+    //
+    // Measure one operation on a type from construction to destruction.
+    // type and operation must remain valid; they are normally the type
+    // name and the name in the type's member table.
+    //
+
+    class OperationScope
+    {
+    public:
+
+        OperationScope(const char * type, const char * operation, const char * index = nullptr)
+            : m_type(type),
+              m_operation(operation),
+              m_hasIndex(index != nullptr),
+              m_start(Instrumentation::Active() ? ChromeTrace::Now() : 0)
+        {
+            if (Instrumentation::Enabled(Instrumentation::Timeline) && (index != nullptr))
+            {
+                //
+                // The member may change its index; keep what it was given.
+                //
+
+                std::strncpy(m_index, index, sizeof(m_index) - 1);
+                m_index[sizeof(m_index) - 1] = '\0';
+            }
+
+            if (Instrumentation::Enabled(Instrumentation::Allocations))
+            {
+                m_allocations.emplace(type, operation);
+            }
+        }
+
+        ~OperationScope()
+        {
+            m_allocations.reset();
+
+            if (Instrumentation::Enabled(Instrumentation::Timeline))
+            {
+                ChromeTrace::Record(m_type, m_operation, m_hasIndex ? m_index : nullptr, m_start, ChromeTrace::Now());
+            }
+        }
+
+        OperationScope(const OperationScope &) = delete;
+        OperationScope & operator=(const OperationScope &) = delete;
+
+        //
+        // Return the time since the operation started, in nanoseconds.
+        //
+
+        uint64_t Elapsed() const
+        {
+            return ChromeTrace::Now() - m_start;
+        }
+
+    private:
+
+        const char * m_type;
+        const char * m_operation;
+        bool m_hasIndex;
+        char m_index[40] = { 0 };
+        uint64_t m_start;
+        std::optional<AllocationAccounting::Scope> m_allocations;
+    };
+}
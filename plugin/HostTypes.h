@@ -0,0 +1,302 @@
+//
+// HostTypes.h
+//
+// Select the type system the collections are hosted on.  Inside MacroQuest
+// this is the real MQ2 type system from mq/Plugin.h.  When
+// MQ2COLLECTIONS_HEADLESS is defined, a small local stand-in for MQ2Type,
+// MQVarPtr and MQTypeVar is used instead so the containers can be built and
+// measured outside of a running client.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#if !defined(MQ2COLLECTIONS_HEADLESS)
+
+#include <mq/Plugin.h>
+
+#else
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//
+// Scalar types and limits used by the MQ2 plugin API.
+//
+
+typedef uint32_t DWORD;
+typedef int BOOL;
+typedef char * PCHAR;
+typedef void * PVOID;
+
+#if !defined(TRUE)
+#define TRUE 1
+#define FALSE 0
+#endif
+
+#if !defined(MAX_STRING)
+#define MAX_STRING 2048
+#endif
+
+#if !defined(_MSC_VER)
+
+//
+// The Microsoft secure CRT functions used by the collections, for compilers
+// that don't provide them.
+//
+
+typedef int errno_t;
+
+inline errno_t strcpy_s(char * dest, size_t size, const char * source)
+{
+    if ((dest == nullptr) || (source == nullptr) || (size == 0))
+    {
+        return EINVAL;
+    }
+
+    size_t length = strlen(source);
+    if (length >= size)
+    {
+        *dest = '\0';
+        return ERANGE;
+    }
+
+    memcpy(dest, source, length + 1);
+    return 0;
+}
+
+inline errno_t strcat_s(char * dest, size_t size, const char * source)
+{
+    if ((dest == nullptr) || (source == nullptr) || (size == 0))
+    {
+        return EINVAL;
+    }
+
+    size_t used = strnlen(dest, size);
+    if (used == size)
+    {
+        return EINVAL;
+    }
+
+    return strcpy_s(dest + used, size - used, source);
+}
+
+#endif  // !defined(_MSC_VER)
+
+class MQ2Type;
+
+//
+// Variable storage passed to and from a type.
+//
+
+struct MQVarPtr
+{
+    union
+    {
+        void * Ptr;
+        float Float;
+        DWORD DWord;
+        int Int;
+        int64_t Int64;
+        uint64_t UInt64;
+        double Double;
+    };
+};
+
+//
+// A variable together with the type that interprets it.
+//
+
+struct MQTypeVar : public MQVarPtr
+{
+    MQ2Type * Type;
+};
+
+//
+// Associate a member id with its name.
+//
+
+struct MQTypeMember
+{
+    DWORD ID;
+    const char * Name;
+};
+
+//
+// Top level object callback.
+//
+
+typedef bool (*fMQData)(const char * szIndex, MQTypeVar & Ret);
+
+//
+// Stand-in for the MQ2 type descriptor.  Member names are resolved the same
+// way MQ2 resolves them: a map lookup on a std::string key taken under a
+// global member map lock.
+//
+
+class MQ2Type
+{
+public:
+
+    explicit MQ2Type(const char * NewName)
+        : m_typeName(NewName)
+    {
+    }
+
+    virtual ~MQ2Type()
+    {
+    }
+
+    MQ2Type(const MQ2Type &) = delete;
+    const MQ2Type & operator=(const MQ2Type &) = delete;
+
+    const char * GetName() const
+    {
+        return m_typeName.c_str();
+    }
+
+    //
+    // Build the member name map from a null terminated array of members.
+    //
+
+    void InitializeMembers(MQTypeMember * MemberArray)
+    {
+        std::lock_guard<std::mutex> lock(MemberMapLock());
+
+        for (size_t i = 0; MemberArray[i].Name != nullptr; ++i)
+        {
+            m_members[MemberArray[i].Name] = MemberArray[i];
+        }
+    }
+
+    //
+    // Return the member descriptor for a name or null if there isn't one.
+    //
+
+    MQTypeMember * FindMember(const char * Name)
+    {
+        std::lock_guard<std::mutex> lock(MemberMapLock());
+
+        auto it = m_members.find(Name);
+        if (it == m_members.end())
+        {
+            return nullptr;
+        }
+
+        return &it->second;
+    }
+
+    virtual bool GetMember(MQVarPtr VarPtr, const char * Member, char * Index, MQTypeVar & Dest) = 0;
+
+    virtual bool ToString(MQVarPtr VarPtr, char * Destination)
+    {
+        return strcpy_s(Destination, MAX_STRING, m_typeName.c_str()) == 0;
+    }
+
+    virtual void InitVariable(MQVarPtr & VarPtr)
+    {
+        VarPtr.Ptr = nullptr;
+    }
+
+    virtual void FreeVariable(MQVarPtr & VarPtr)
+    {
+    }
+
+    virtual bool FromData(MQVarPtr & VarPtr, const MQTypeVar & Source)
+    {
+        return false;
+    }
+
+    virtual bool FromString(MQVarPtr & VarPtr, const char * Source)
+    {
+        return false;
+    }
+
+    //
+    // Lock shared by all member maps, standing in for ghMemberMapLock.
+    //
+
+    static std::mutex & MemberMapLock()
+    {
+        static std::mutex lock;
+
+        return lock;
+    }
+
+private:
+
+    std::string m_typeName;
+
+    std::unordered_map<std::string, MQTypeMember> m_members;
+};
+
+namespace mq
+{
+    namespace datatypes
+    {
+        //
+        // Scalar type with no members, used for the bool, int, int64 and
+        // string result types.
+        //
+
+        class MQ2HostScalarType : public MQ2Type
+        {
+        public:
+
+            explicit MQ2HostScalarType(const char * name)
+                : MQ2Type(name)
+            {
+            }
+
+            bool GetMember(MQVarPtr VarPtr, const char * Member, char * Index, MQTypeVar & Dest) override
+            {
+                return false;
+            }
+        };
+
+        inline MQ2HostScalarType hostBoolType("bool");
+        inline MQ2HostScalarType hostIntType("int");
+        inline MQ2HostScalarType hostInt64Type("int64");
+        inline MQ2HostScalarType hostStringType("string");
+
+        inline MQ2Type * pBoolType = &hostBoolType;
+        inline MQ2Type * pIntType = &hostIntType;
+        inline MQ2Type * pInt64Type = &hostInt64Type;
+        inline MQ2Type * pStringType = &hostStringType;
+    }
+}
+
+//
+// Top level objects registered with the host.
+//
+
+inline std::map<std::string, fMQData> & HostTopLevelObjects()
+{
+    static std::map<std::string, fMQData> topLevelObjects;
+
+    return topLevelObjects;
+}
+
+inline bool AddMQ2Data(const char * szName, fMQData Function)
+{
+    return HostTopLevelObjects().emplace(szName, Function).second;
+}
+
+inline bool RemoveMQ2Data(const char * szName)
+{
+    return HostTopLevelObjects().erase(szName) != 0;
+}
+
+inline void DebugSpewAlways(const char * szFormat, ...)
+{
+}
+
+#endif  // !defined(MQ2COLLECTIONS_HEADLESS)
@@ -3,10 +3,18 @@
 //
 
 #include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "List.h"
+#include "MemberDispatch.h"
 #include "StringExtensions.h"
+#include "ArgumentCache.h"
 #include "Conversions.h"
 
 using namespace Collections::Containers;
@@ -18,7 +26,7 @@ using namespace Conversions;
 // contain a null string pointer.
 //
 
-const MQTypeMember ListIterator::ListIteratorMembers[] =
+constexpr MQTypeMember ListIterator::ListIteratorMembers[] =
 {
     { (DWORD) ListIteratorMembers::Reset, "Reset" },
     { (DWORD) ListIteratorMembers::Advance, "Advance" },
@@ -33,7 +41,7 @@ const MQTypeMember ListIterator::ListIteratorMembers[] =
 // string pointer.
 //
 
-const MQTypeMember List::ListMembers[] =
+constexpr MQTypeMember List::ListMembers[] =
 {
     { (DWORD) ListMembers::Count, "Count" },
     { (DWORD) ListMembers::Clear, "Clear" },
@@ -54,6 +62,9 @@ const MQTypeMember List::ListMembers[] =
     { (DWORD) ListMembers::Tail, "Tail" },
     { (DWORD) ListMembers::CountOf, "CountOf" },
     { (DWORD) ListMembers::Delimiter, "Delimiter" },
+    { (DWORD) ListMembers::Indexed, "Indexed" },
+    { (DWORD) ListMembers::RemoveAll, "RemoveAll" },
+    { (DWORD) ListMembers::ReplaceMany, "ReplaceMany" },
     { 0, 0 }
 };
 
@@ -65,9 +76,8 @@ const MQTypeMember List::ListMembers[] =
 // Constructor.
 //
 
-ListIterator::ListIterator(const std::list<std::string> & refCollection)
-    : ValueIterator<std::list<std::string>>(refCollection),
-      ReferenceType(ListIteratorMembers)
+ListIterator::ListIterator(const CountedList<std::string> & refCollection)
+    : ValueIterator<CountedList<std::string>>(refCollection)
 {
 }
 
@@ -77,10 +87,9 @@ ListIterator::ListIterator(const std::list<std::string> & refCollection)
 //
 
 ListIterator::ListIterator(
-                    const std::list<std::string> & refCollection,
-                    const std::string & refKey)
-    : ValueIterator<std::list<std::string>>(refCollection),
-      ReferenceType(ListIteratorMembers)
+                    const CountedList<std::string> & refCollection,
+                    std::string_view refKey)
+    : ValueIterator<CountedList<std::string>>(refCollection)
 {
     //
     // Position the iterator to the item or to the end of the
@@ -90,13 +99,24 @@ ListIterator::ListIterator(
     Find(refKey);
 }
 
+//
+// Constructor - position the iterator on an item already found.
+//
+
+ListIterator::ListIterator(
+                    const CountedList<std::string> & refCollection,
+                    CountedList<std::string>::const_iterator position)
+    : ValueIterator<CountedList<std::string>>(refCollection)
+{
+    m_iterator = position;
+}
+
 //
 // Copy constructor for a list iterator.
 //
 
 ListIterator::ListIterator(const ListIterator & original)
-    : ValueIterator<std::list<std::string>>(original),
-      ReferenceType(ListIteratorMembers)
+    : ValueIterator<CountedList<std::string>>(original)
 {
 }
 
@@ -118,40 +138,33 @@ const char *ListIterator::GetTypeName()
 }
 
 //
-// Cloned iterators can be deleted.
+// Clone this iterator, creating a new one.
 //
 
-const bool ListIterator::CanDelete() const
+std::unique_ptr<ListIterator> ListIterator::Clone() const
 {
-    return Cloned();
+    return std::make_unique<ListIterator>(*this);
 }
 
 //
-// Clone this iterator, creating a new one.
+// Return the member table that names the members to MQ2.
 //
 
-std::unique_ptr<ListIterator> ListIterator::Clone() const
+const MQTypeMember * ListIterator::GetMembers()
 {
-    return std::make_unique<ListIterator>(*this);
+    return ListIteratorMembers;
 }
 
 //
-// Return the value in the list under the current iterator.
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
 //
 
-bool ListIterator::Value(const std::string ** const item) const
+const MQTypeMember * ListIterator::LookupMember(const char * Name)
 {
-    //
-    // Return false if we are after the end of the list.
-    //
+    static constexpr Types::MemberDispatch<std::size(ListIteratorMembers)> dispatch(ListIteratorMembers);
 
-    if (IsEnd())
-    {
-        return false;
-    }
-
-    *item = &(*m_iterator);
-    return true;
+    return dispatch.Find(Name);
 }
 
 //
@@ -159,7 +172,7 @@ bool ListIterator::Value(const std::string ** const item) const
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool ListIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+bool ListIterator::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
 {
     ListIterator * pThis;
     MQTypeVar typeVar;
@@ -176,7 +189,7 @@ bool ListIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, M
     // Map the member name to the id.
     //
 
-	auto pMember = ListIterator::FindMember(Member);
+	auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -235,7 +248,7 @@ bool ListIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, M
 
             if (pThis->Value(&pItem))
             {
-                Dest.Ptr = (PVOID) pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                Dest.Ptr = (PVOID) pItem->c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -319,7 +332,7 @@ bool ListIterator::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // Return false because this operation is not supported.
 //
 
-bool ListIterator::FromString(MQVarPtr& VarPtr, const char* Source)
+bool ListIterator::AssignFromString(MQVarPtr& VarPtr, const char* Source)
 {
     return false;
 }
@@ -329,7 +342,7 @@ bool ListIterator::FromString(MQVarPtr& VarPtr, const char* Source)
 // false if the key is not found.
 //
 
-bool ListIterator::Find(const std::string & refKey)
+bool ListIterator::Find(std::string_view refKey)
 {
     m_iterator = std::find(m_refCollection.cbegin(), m_refCollection.cend(), refKey);
 
@@ -345,8 +358,9 @@ bool ListIterator::Find(const std::string & refKey)
 //
 
 List::List()
-    : ObjectType(ListMembers),
-      m_delimiter(",")
+    : m_delimiter(","),
+      m_cursorPosition(0),
+      m_cursorValid(false)
 {
 }
 
@@ -355,10 +369,24 @@ List::List()
 //
 
 List::List(const std::list<std::string> & source)
-    : ObjectType(ListMembers),
-      m_delimiter(",")
+    : m_delimiter(","),
+      m_cursorPosition(0),
+      m_cursorValid(false)
+{
+    m_coll.assign(source.cbegin(), source.cend());
+}
+
+//
+// Construct a new list from a range of another list.
+//
+
+List::List(CountedList<std::string>::const_iterator first,
+           CountedList<std::string>::const_iterator last)
+    : m_delimiter(","),
+      m_cursorPosition(0),
+      m_cursorValid(false)
 {
-    m_coll = source;
+    m_coll.assign(first, last);
 }
 
 //
@@ -382,8 +410,13 @@ const char *List::GetTypeName()
 // Return true if a key is in the list.
 //
 
-bool List::Contains(const std::string & item) const
+bool List::Contains(std::string_view item) const
 {
+    if (m_index)
+    {
+        return m_index->CountOf(item) != 0;
+    }
+
     return std::find(m_coll.cbegin(), m_coll.cend(), item) != m_coll.end();
 }
 
@@ -393,10 +426,21 @@ bool List::Contains(const std::string & item) const
 // match item then the index of only the first is returned.
 //
 
-long List::Index(const std::string & item) const
+long List::Index(std::string_view item) const
 {
     long nPosition;
 
+    //
+    // An indexed list knows where the first occurrence is.
+    //
+
+    if (m_index)
+    {
+        auto it = m_index->Find(m_coll, item);
+
+        return (it == m_coll.cend()) ? -1 : (long) m_coll.index_of(it);
+    }
+
     //
     // Compare each element in the list until key is found or we reach the
     // end of the list.
@@ -455,6 +499,21 @@ bool List::Item(const size_t index, const std::string ** const item) const
     return false;
 }
 
+//
+// Delete every item in the list.
+//
+
+void List::Clear()
+{
+    m_coll.clear();
+    ForgetCursor();
+
+    if (m_index)
+    {
+        m_index->Clear();
+    }
+}
+
 //
 // Sort the list into ascending order.  The list is altered in
 // place.
@@ -463,6 +522,12 @@ bool List::Item(const size_t index, const std::string ** const item) const
 void List::Sort()
 {
     m_coll.sort();
+    ForgetCursor();
+
+    if (m_index)
+    {
+        m_index->Reordered();
+    }
 }
 
 //
@@ -473,15 +538,26 @@ void List::Sort()
 void List::Reverse()
 {
     m_coll.reverse();
+    ForgetCursor();
+
+    if (m_index)
+    {
+        m_index->Reordered();
+    }
 }
 
 //
 // Append an item to the end of the list.
 //
 
-void List::Append(const std::string & item)
+void List::Append(std::string_view item)
 {
-    m_coll.push_back(item);
+    m_coll.emplace_back(item);
+
+    if (m_index)
+    {
+        m_index->Inserted(m_coll, std::prev(m_coll.cend()));
+    }
 }
 
 //
@@ -489,22 +565,31 @@ void List::Append(const std::string & item)
 // number of items that matched item.
 //
 
-size_t List::Remove(const std::string & item)
+size_t List::Remove(std::string_view item)
 {
     //
-    // Count how many times item occurs in the list.
+    // An indexed list knows whether there is anything to remove.
     //
 
-    auto itemCount = std::count(m_coll.cbegin(), m_coll.cend(), item);
+    if (m_index && (m_index->CountOf(item) == 0))
+    {
+        return 0;
+    }
 
     //
-    // Remove the item if there are any in the list.  This test saves an
-    // additional pass over the list for the removal.
+    // Remove and count the matching items in one pass.
     //
 
+    auto itemCount = m_coll.remove_if([item](const std::string & element) { return element == item; });
+
     if (itemCount != 0)
     {
-        m_coll.remove(item);
+        ForgetCursor();
+
+        if (m_index)
+        {
+            m_index->Removed(item);
+        }
     }
 
     return itemCount;
@@ -531,7 +616,14 @@ bool List::Erase(const size_t index)
     // Otherwise, remove the element.
     //
 
+    if (m_index)
+    {
+        m_index->Erasing(it);
+    }
+
     m_coll.erase(it);
+    ForgetCursor();
+
     return true;
 }
 
@@ -540,21 +632,35 @@ bool List::Erase(const size_t index)
 // of items replaced.
 //
 
-size_t List::Replace(const std::string & item, const std::string & newItem)
+size_t List::Replace(std::string_view item, std::string_view newItem)
 {
     //
-    // Count the items so we can return the replacement count.
+    // An indexed list knows whether there is anything to replace.
     //
 
-    size_t replacedElements = CountOf(item);
+    if (m_index && (m_index->CountOf(item) == 0))
+    {
+        return 0;
+    }
+
+    //
+    // Replace the items in place, counting them in the same pass.
+    //
 
-    if (replacedElements != 0)
+    size_t replacedElements = 0;
+
+    for (auto & element : m_coll)
     {
-        //
-        // Replacement is done in-place.
-        //
+        if (element == item)
+        {
+            element = newItem;
+            ++replacedElements;
+        }
+    }
 
-        std::replace(m_coll.begin(), m_coll.end(), item, newItem);
+    if ((replacedElements != 0) && m_index)
+    {
+        m_index->Replaced(m_coll, item, newItem);
     }
 
     return replacedElements;
@@ -565,12 +671,14 @@ size_t List::Replace(const std::string & item, const std::string & newItem)
 // end.
 //
 
-ValueIterator<std::list<std::string>> * List::Find(
-        const std::string & refKey)
+ListIterator * List::Find(std::string_view refKey)
 {
-    m_findIter = std::make_unique<ListIterator>(m_coll, refKey);
+    if (m_index)
+    {
+        return m_findIter.Reset(std::make_unique<ListIterator>(m_coll, m_index->Find(m_coll, refKey)));
+    }
 
-    return m_findIter.get();
+    return m_findIter.Reset(std::make_unique<ListIterator>(m_coll, refKey));
 }
 
 //
@@ -579,6 +687,29 @@ ValueIterator<std::list<std::string>> * List::Find(
 //
 
 bool List::Head(std::unique_ptr<const std::string> * item)
+{
+    std::string value;
+
+    if (!Head(&value))
+    {
+        return false;
+    }
+
+    //
+    // The caller is responsible for deleting the string.
+    //
+
+    *item = std::make_unique<const std::string>(std::move(value));
+
+    return true;
+}
+
+//
+// Remove the head of the list and move it into item.  Return true if
+// there was a head and false otherwise.
+//
+
+bool List::Head(std::string * item)
 {
     //
     // Only return the head if there are entries in the list.
@@ -587,15 +718,18 @@ bool List::Head(std::unique_ptr<const std::string> * item)
     if (Count() > 0)
     {
         //
-        // Copy the head of the list to a new std::string and return
-        // that string to the caller.  Then remove the head and
-        // return true.
-        //
-        // The caller is responsible for deleting the string.
+        // Move the head of the list to the caller's string, so that its
+        // characters aren't copied.  Then remove the head and return true.
         //
 
-        *item = std::make_unique<const std::string>(m_coll.front());
+        if (m_index)
+        {
+            m_index->Erasing(m_coll.cbegin());
+        }
+
+        *item = std::move(m_coll.front());
         m_coll.pop_front();
+        ForgetCursor();
 
         return true;
     }
@@ -609,6 +743,29 @@ bool List::Head(std::unique_ptr<const std::string> * item)
 //
 
 bool List::Tail(std::unique_ptr<const std::string> * item)
+{
+    std::string value;
+
+    if (!Tail(&value))
+    {
+        return false;
+    }
+
+    //
+    // The caller is responsible for deleting the string.
+    //
+
+    *item = std::make_unique<const std::string>(std::move(value));
+
+    return true;
+}
+
+//
+// Remove the tail of the list and move it into item.  Return true if
+// there was a tail and false otherwise.
+//
+
+bool List::Tail(std::string * item)
 {
     //
     // Only return the tail if there are entries in the list.
@@ -617,15 +774,18 @@ bool List::Tail(std::unique_ptr<const std::string> * item)
     if (Count() > 0)
     {
         //
-        // Copy the tail of the list to a new std::string and return
-        // that string to the caller.  Then remove the tail and
-        // return true.
-        //
-        // The caller is responsible for deleting the string.
+        // Move the tail of the list to the caller's string, so that its
+        // characters aren't copied.  Then remove the tail and return true.
         //
 
-        *item = std::make_unique<const std::string>(m_coll.back());
+        if (m_index)
+        {
+            m_index->Erasing(std::prev(m_coll.cend()));
+        }
+
+        *item = std::move(m_coll.back());
         m_coll.pop_back();
+        ForgetCursor();
 
         return true;
     }
@@ -637,11 +797,43 @@ bool List::Tail(std::unique_ptr<const std::string> * item)
 // Return a count of how many times item occurs in the list.
 //
 
-size_t List::CountOf(const std::string & item) const
+size_t List::CountOf(std::string_view item) const
 {
+    if (m_index)
+    {
+        return m_index->CountOf(item);
+    }
+
     return std::count(m_coll.cbegin(), m_coll.cend(), item);
 }
 
+//
+// Return true if the list keeps an index of its values.
+//
+
+bool List::IsIndexed() const
+{
+    return m_index != nullptr;
+}
+
+//
+// Start or stop keeping an index of the list's values.  Starting indexes
+// every item already in the list.
+//
+
+void List::SetIndexed(bool indexed)
+{
+    if (!indexed)
+    {
+        m_index.reset();
+    }
+    else if (!m_index)
+    {
+        m_index = std::make_unique<ListIndex>();
+        m_index->Build(m_coll);
+    }
+}
+
 //
 // Create a splice from a starting index to the end of the list. If startIndex is past
 // the end of the list, an empty list is returned.
@@ -663,9 +855,7 @@ std::unique_ptr<List> List::Splice(size_t startIndex) const
     // Return a splice from the range.
     //
 
-    std::list<std::string> newList(FindIteratorForPosition(startIndex), m_coll.cend());
-
-    return std::make_unique<List>(newList);
+    return std::make_unique<List>(FindIteratorForPosition(startIndex), m_coll.cend());
 }
 
 //
@@ -691,11 +881,30 @@ std::unique_ptr<List> List::Splice(size_t startIndex, size_t length) const
     // Return a splice from the range.
     //
 
-    std::list<std::string> newList(
+    return std::make_unique<List>(
                             FindIteratorForPosition(startIndex),
                             FindIteratorForPosition(startIndex + length));
+}
+
+//
+// Return the member table that names the members to MQ2.
+//
 
-    return std::make_unique<List>(newList);
+const MQTypeMember * List::GetMembers()
+{
+    return ListMembers;
+}
+
+//
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
+//
+
+const MQTypeMember * List::LookupMember(const char * Name)
+{
+    static constexpr Types::MemberDispatch<std::size(ListMembers)> dispatch(ListMembers);
+
+    return dispatch.Find(Name);
 }
 
 //
@@ -703,11 +912,10 @@ std::unique_ptr<List> List::Splice(size_t startIndex, size_t length) const
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+bool List::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
 {
     List * pThis;
     MQTypeVar typeVar;
-    std::unique_ptr<const std::string> pItem;
     size_t replacedItems;
 
     //
@@ -721,7 +929,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
     // Map the member name to the id.
     //
 
-    auto pMember = List::FindMember(Member);
+    auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -773,7 +981,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = pThis->Contains(std::string(Index)) ? 1 : 0;
+                Dest.Int = pThis->Contains(Index) ? 1 : 0;
             }
             break;
 
@@ -782,7 +990,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
             // Return a splice from this list.
             //
 
-            Dest.Ptr = (PVOID) pThis->CreateSplice(std::string(Index)).release();
+            Dest.Ptr = (PVOID) pThis->CreateSplice(Index).release();
 
             //
             // Get the List type and return it.
@@ -804,7 +1012,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
                 // -1 is returned if the index was not found.
                 //
 
-                Dest.Int = (int) pThis->Index(std::string(Index));
+                Dest.Int = (int) pThis->Index(Index);
                 Dest.Type = mq::datatypes::pIntType;
             }
             break;
@@ -825,9 +1033,11 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
                 //
 
                 std::string const * pItem;
-                if (pThis->Item(std::string(Index), &pItem))
+                size_t lIndex;
+
+                if (pThis->IndexValueFromString(Index, &lIndex) && pThis->Item(lIndex, &pItem))
                 {
-                    Dest.Ptr = (PVOID) pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                    Dest.Ptr = (PVOID) pItem->c_str();
                     Dest.Type = mq::datatypes::pStringType;
                 }
             }
@@ -844,7 +1054,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Insert(std::string(Index));
+                Dest.Int = (int) pThis->Insert(Index);
             }
 
             break;
@@ -880,7 +1090,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                pThis->AppendItems(std::string(Index));
+                pThis->AppendItems(Index);
 
                 //
                 // Return TRUE.
@@ -901,7 +1111,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Remove(std::string(Index));
+                Dest.Int = (int) pThis->Remove(Index);
                 Dest.Type = mq::datatypes::pIntType;
             }
             break;
@@ -918,7 +1128,9 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Erase(std::string(Index));
+                size_t lIndex;
+
+                Dest.Int = (int) (pThis->IndexValueFromString(Index, &lIndex) && pThis->Erase(lIndex));
             }
             break;
 
@@ -934,7 +1146,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                if (pThis->Replace(std::string(Index), &replacedItems))
+                if (pThis->Replace(Index, &replacedItems))
                 {
                     Dest.Int = (int) replacedItems;
                     Dest.Type = mq::datatypes::pIntType;
@@ -968,7 +1180,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Ptr = (PVOID) pThis->Find(std::string(Index));
+                Dest.Ptr = (PVOID) pThis->Find(Index);
 
                 //
                 // Get the ListIterator type and return it.
@@ -985,9 +1197,9 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
             // isn't one.
             //
 
-            if (pThis->Head(&pItem))
+            if (pThis->Head(&ResultSlot<List>::Value()))
             {
-                Dest.Ptr = (PVOID) pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                Dest.Ptr = (PVOID) ResultSlot<List>::Pointer();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -998,9 +1210,9 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
             // isn't one.
             //
 
-            if (pThis->Tail(&pItem))
+            if (pThis->Tail(&ResultSlot<List>::Value()))
             {
-                Dest.Ptr = (PVOID) pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                Dest.Ptr = (PVOID) ResultSlot<List>::Pointer();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -1016,7 +1228,7 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->CountOf(std::string(Index));
+                Dest.Int = (int) pThis->CountOf(Index);
                 Dest.Type = mq::datatypes::pIntType;
             }
             break;
@@ -1028,12 +1240,62 @@ bool List::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                auto old_delimiter = pThis->Delimiter(std::string(Index));
-                Dest.Ptr = (PVOID)pThis->m_Buffer.SetBuffer(old_delimiter.c_str(), old_delimiter.size() + 1);
+                const auto & delimiter = pThis->Delimiter(Index);
+                Dest.Ptr = (PVOID) delimiter.c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
 
+        case ListMembers::Indexed:
+            //
+            // Turn the index on with TRUE and off with FALSE.  Return
+            // whether the list is indexed.
+            //
+
+            if (NOT_EMPTY(Index))
+            {
+                bool indexed;
+
+                if (!BooleanFromString(Index, &indexed))
+                {
+                    break;
+                }
+
+                pThis->SetIndexed(indexed);
+            }
+
+            Dest.Int = pThis->IsIndexed() ? 1 : 0;
+            break;
+
+        case ListMembers::RemoveAll:
+            //
+            // Remove every occurrence of each item in a sequence.  Return how
+            // many items were removed.
+            //
+
+            if (NOT_EMPTY(Index))
+            {
+                Dest.Int = (int) pThis->RemoveItems(Index);
+                Dest.Type = mq::datatypes::pIntType;
+            }
+            break;
+
+        case ListMembers::ReplaceMany:
+            //
+            // Replace each source with its target in a sequence of
+            // source=target pairs.  Return how many items were replaced.
+            //
+
+            if (NOT_EMPTY(Index))
+            {
+                if (pThis->ReplaceItems(Index, &replacedItems))
+                {
+                    Dest.Int = (int) replacedItems;
+                    Dest.Type = mq::datatypes::pIntType;
+                }
+            }
+            break;
+
         default:
 
             //
@@ -1088,7 +1350,7 @@ bool List::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // this as a list Append call.
 //
 
-bool List::FromString(MQVarPtr& VarPtr, const char* Source)
+bool List::AssignFromString(MQVarPtr& VarPtr, const char* Source)
 {
     List * pDest;
 
@@ -1100,75 +1362,65 @@ bool List::FromString(MQVarPtr& VarPtr, const char* Source)
 
     if ((pDest != nullptr) && NOT_EMPTY(Source))
     {
-        pDest->Append(std::string(Source));
+        pDest->Append(Source);
     }
 
     return true;
 }
 
-//
-// Return an iterator on the list.
-//
-
-std::unique_ptr<ValueIterator<std::list<std::string>>> List::GetNewIterator(
-                    const std::list<std::string> & refCollection) const
-{
-    return std::make_unique<ListIterator>(refCollection);
-}
-
 //
 // Return an iterator for a position index.  Position 0 means
 // the beginning of the list.  If position is beyond the end
 // of the list, return m_coll.end().
 //
 
-std::list<std::string>::const_iterator List::FindIteratorForPosition(size_t position) const
+CountedList<std::string>::const_iterator List::FindIteratorForPosition(size_t position) const
 {
-    //
-    // If position is past the end of the list, return an iterator
-    // to the end of the list.
-    //
+    auto count = Count();
 
-    if (position >= Count())
+    if (position >= count)
     {
         return m_coll.cend();
     }
 
-    auto it = m_coll.cbegin();
-    while (position != 0)
-    {
-        --position;
-        ++it;
-    }
-
-    return it;
-}
-
-//
-// Retrieve the index'th value from the list.  Return true if index
-// is in the bounds of the list and false otherwise.  Index can
-// be negative, in which case it is an offset from the end of the
-// list.
-//
-
-bool List::Item(const std::string & index, const std::string ** const item) const
-{
-    size_t lIndex;
-
     //
-    // Convert the string to an index value.  Fail if we can not convert it.
+    // Step from the cursor when the position is near it, as it is when a
+    // macro indexes the list in order, or from the nearer end of the list.
+    // Otherwise search the tree.
     //
 
-    if (!IndexValueFromString(index, &lIndex))
+    CountedList<std::string>::const_iterator it;
+
+    if (m_cursorValid
+        && (position >= m_cursorPosition)
+        && (position - m_cursorPosition <= CursorReach))
     {
-        return false;
+        it = std::next(m_cursor, position - m_cursorPosition);
+    }
+    else if (m_cursorValid
+             && (position < m_cursorPosition)
+             && (m_cursorPosition - position <= CursorReach))
+    {
+        it = std::prev(m_cursor, m_cursorPosition - position);
+    }
+    else if (position <= CursorReach)
+    {
+        it = std::next(m_coll.cbegin(), position);
+    }
+    else if (count - position <= CursorReach)
+    {
+        it = std::prev(m_coll.cend(), count - position);
+    }
+    else
+    {
+        it = m_coll.nth(position);
     }
 
-    //
-    // Get the item from the position.
-    //
+    m_cursor = it;
+    m_cursorPosition = position;
+    m_cursorValid = true;
 
-    return Item(lIndex, item);
+    return it;
 }
 
 //
@@ -1176,7 +1428,7 @@ bool List::Item(const std::string & index, const std::string ** const item) cons
 // Return true if the items could be inserted and false otherwise.
 //
 
-bool List::Insert(const std::string & args)
+bool List::Insert(std::string_view args)
 {
     size_t lIndex;
 
@@ -1200,7 +1452,7 @@ bool List::Insert(const std::string & args)
     // Acquire the index value.
     //
 
-    if (!IndexValueFromString(args.substr(0, comma_pos), &lIndex))
+    if (!IndexValueFromString(args.data(), args.data() + comma_pos, &lIndex))
     {
         return false;
     }
@@ -1217,93 +1469,225 @@ bool List::Insert(const std::string & args)
     }
 
     //
-    // Split the string into extents.  Each extent represents an argument
-    // to insert.
+    // Don't insert if the index is beyond the end of the list.
     //
 
-    auto arguments = std::make_unique<StringExtensions>(args.substr(comma_pos + 1));
-    auto coll = arguments->Split(StringExtensions::string_type(m_delimiter));
+    if (lIndex > Count())
+    {
+        return false;
+    }
+
+    //
+    // Split the string into extents and insert each one before the item at
+    // the index as it is found.  A recently seen argument isn't split again.
+    //
 
-    return Insert(lIndex, *coll);
+    auto it = FindIteratorForPosition(lIndex);
+
+    ArgumentCache::ForEach(GetTypeName(),
+                           "Insert",
+                           args.substr(comma_pos + 1),
+                           m_delimiter,
+                           [this, it] (std::string_view item)
+                           {
+                               auto inserted = m_coll.emplace(it, item);
+
+                               if (m_index)
+                               {
+                                   m_index->Inserted(m_coll, inserted);
+                               }
+                           });
+
+    ForgetCursor();
+
+    return true;
 }
 
 //
 // Append a sequence of items onto the end of the list.
 //
 
-void List::AppendItems(const std::string & args)
+void List::AppendItems(std::string_view args)
 {
     //
-    // Split the string into extents.  Each extent represents an argument
-    // to insert.  An empty collection will append no strings.
+    // Split the string into extents and append each one as it is found.
+    // A recently seen argument isn't split again.
     //
 
-    auto arguments = std::make_unique<StringExtensions>(args);
-    auto coll = arguments->Split(StringExtensions::string_type(m_delimiter));
-
-    std::for_each(coll->cbegin(),
-                  coll->cend(),
-                  [this] (const std::string & item)
-                  {
-                      Append(item);
-                  }
-    );
+    ArgumentCache::ForEach(GetTypeName(),
+                           "Append",
+                           args,
+                           m_delimiter,
+                           [this] (std::string_view item)
+                           {
+                               Append(item);
+                           });
 }
 
 //
-// Erase an index in the list.  Index can be negative, in which
-// case it is an offset from the end of the list.  Return true if
-// the item was erased (deleted) and false otherwise.
+// Replace a source item with a target item.  The argument must
+// be a list of two items.  Count is set to the number of times
+// the source was replaced by the target.  True is returned if
+// there are two arguments and false otherwise.
 //
 
-bool List::Erase(const std::string & index)
+bool List::Replace(std::string_view args, size_t * count)
 {
-    size_t lIndex;
+    size_t replaceCount;
 
     //
-    // Acquire the index value.
+    // Split the strings and ensure there are two arguments.
     //
 
-    if (!IndexValueFromString(index, &lIndex))
+    const auto & items = ArgumentCache::Split(GetTypeName(), "Replace", args, ",");
+
+    if (items.size() != 2)
     {
         return false;
     }
 
     //
-    // And erase the item.
+    // Replace the first string with the second.
     //
 
-    return Erase(lIndex);
+    replaceCount = Replace(items[0], items[1]);
+
+    if (count)
+    {
+        *count = replaceCount;
+    }
+
+    return true;
 }
 
 //
-// Replace a source item with a target item.  The argument must
-// be a list of two items.  Count is set to the number of times
-// the source was replaced by the target.  True is returned if
-// there are two arguments and false otherwise.
+// Remove every occurrence of each item in a sequence from the list.  Return
+// the number of items removed.
 //
 
-bool List::Replace(const std::string & args, size_t * count)
+size_t List::RemoveItems(std::string_view args)
 {
-    size_t replaceCount;
+    const auto & items = ArgumentCache::Split(GetTypeName(), "RemoveAll", args, m_delimiter);
 
     //
-    // Split the strings and ensure there are two arguments.
+    // Gather the items to remove, leaving out any that an indexed list
+    // knows it doesn't hold.
     //
 
-    auto arguments = std::make_unique<StringExtensions>(args);
-    auto coll = arguments->Split(StringExtensions::string_type(","));
+    std::unordered_set<std::string_view> targets;
 
-    if (coll->size() != 2)
+    for (const auto & item : items)
     {
-        return false;
+        if (!m_index || (m_index->CountOf(item) != 0))
+        {
+            targets.emplace(item);
+        }
+    }
+
+    if (targets.empty())
+    {
+        return 0;
     }
 
     //
-    // Replace the first string with the second.
+    // Then remove and count them all in one pass over the list.
+    //
+
+    auto removed = m_coll.remove_if([&targets](const std::string & element) { return targets.count(element) != 0; });
+
+    if (removed != 0)
+    {
+        ForgetCursor();
+
+        if (m_index)
+        {
+            for (auto target : targets)
+            {
+                m_index->Removed(target);
+            }
+        }
+    }
+
+    return removed;
+}
+
+//
+// Replace items from a sequence of source=target pairs.  Each item is
+// compared with the sources as it was before the call, so a=b,b=a swaps a
+// and b.  Count is set to the number of items replaced.  True is returned
+// if every pair has an = and false otherwise.
+//
+
+bool List::ReplaceItems(std::string_view args, size_t * count)
+{
+    const auto & items = ArgumentCache::Split(GetTypeName(), "ReplaceMany", args, m_delimiter);
+
+    //
+    // Map each source onto its target, leaving out any source that an
+    // indexed list knows it doesn't hold.  If a source is repeated, its
+    // first target is used.
+    //
+
+    std::unordered_map<std::string_view, std::string_view> replacements;
+
+    for (const auto & item : items)
+    {
+        auto equals = item.find('=');
+
+        if (equals == std::string::npos)
+        {
+            return false;
+        }
+
+        std::string_view pair(item);
+        std::string_view source = pair.substr(0, equals);
+
+        if (!m_index || (m_index->CountOf(source) != 0))
+        {
+            replacements.emplace(source, pair.substr(equals + 1));
+        }
+    }
+
+    if (replacements.empty())
+    {
+        if (count)
+        {
+            *count = 0;
+        }
+
+        return true;
+    }
+
+    //
+    // Replace the items in place in one pass over the list.  An indexed list
+    // counts each replaced item out under its old value and back in under
+    // its new one.
     //
 
-    replaceCount = Replace(coll->at(0), coll->at(1));
+    size_t replaceCount = 0;
+
+    for (auto it = m_coll.begin(); it != m_coll.end(); ++it)
+    {
+        auto replacement = replacements.find(*it);
+
+        if (replacement == replacements.end())
+        {
+            continue;
+        }
+
+        if (m_index)
+        {
+            m_index->Erasing(it);
+        }
+
+        it->assign(replacement->second);
+        ++replaceCount;
+
+        if (m_index)
+        {
+            m_index->Inserted(m_coll, it);
+        }
+    }
 
     if (count)
     {
@@ -1324,7 +1708,7 @@ bool List::Replace(const std::string & args, size_t * count)
 //                          entries is returned.
 //
 
-std::unique_ptr<List> List::CreateSplice(const std::string & args) const
+std::unique_ptr<List> List::CreateSplice(std::string_view args) const
 {
     //
     // Default iterators are beginning and ending.
@@ -1334,20 +1718,14 @@ std::unique_ptr<List> List::CreateSplice(const std::string & args) const
     auto end_it = m_coll.cend();
 
     //
-    // Split the strings and find out how many arguments there are, removing empty
-    // strings from the output.
+    // Trim the string. Then if it is not empty, split it into items.  A
+    // recently seen argument isn't split again.
     //
 
-    auto arguments = std::make_unique<StringExtensions>(args);
-
-    //
-    // Trim the string. Then if it is not empty, parse it into items.
-    //
-
-    auto trimmed_string = arguments->Trim();
-    if (!trimmed_string->Contents().empty())
+    auto trimmed = TrimView(args);
+    if (!trimmed.empty())
     {
-        auto coll = trimmed_string->Split(StringExtensions::string_type(","));
+        const auto & coll = ArgumentCache::Split(GetTypeName(), "Splice", trimmed, ",");
 
         //
         // Update the iterators if there are arguments.
@@ -1358,14 +1736,16 @@ std::unique_ptr<List> List::CreateSplice(const std::string & args) const
 
         //
         // There is at least a starting index.
-        if (coll->size() > 0)
+        if (coll.size() > 0)
         {
             //
             // Select from index to end if index is valid. Otherwise use the end as the
             // starting element.
             //
 
-            if (IndexValueFromString((*coll)[0], &startIndex))
+            const auto & start = coll[0];
+
+            if (IndexValueFromString(start.data(), start.data() + start.size(), &startIndex))
             {
                 start_it = FindIteratorForPosition(startIndex);
             }
@@ -1377,41 +1757,39 @@ std::unique_ptr<List> List::CreateSplice(const std::string & args) const
 
         //
         // Two arguments means there is a start and length. Pick up the length.
-        if (coll->size() == 2)
+        if (coll.size() == 2)
         {
             size_t length;
 
             //
-            // Select the length and add it to the start if it is valid.
+            // Select the length and add it to the start if it is valid.  A
+            // negative length or one longer than the list selects to the end.
             //
 
-            if (IndexValueFromString((*coll)[1], &length))
+            if (ParseInteger(coll[1].data(), coll[1].data() + coll[1].size(), &length)
+                && (length <= Count()))
             {
                 end_it = FindIteratorForPosition(startIndex + length);
             }
         }
     }
 
-    std::list<std::string> splice(start_it, end_it);
-    return std::make_unique<List>(splice);
+    return std::make_unique<List>(start_it, end_it);
 }
 
 //
 // Convert an index value from a string.  Return true if the
-// string could be converted and false otherwise.
+// string could be converted and false otherwise.  A negative
+// index is an offset from the end of the list: -1 is the last
+// item.
 //
 
-bool List::IndexValueFromString(const std::string & stringIndex, size_t * longIndex) const
+bool List::IndexValueFromString(const char * first, const char * last, size_t * longIndex) const
 {
+    int64_t signedIndex;
     size_t lIndex;
 
-    //
-    // Select all elements of the list from startIndex to the end of
-    // the list.  If startIndex is negative, use it as an offset from
-    // the end of the list.
-    //
-
-    if (!Extensions::Strings::FromString(stringIndex, &lIndex))
+    if (!ParseInteger(first, last, &signedIndex))
     {
         //
         // Can't convert the index.
@@ -1433,6 +1811,19 @@ bool List::IndexValueFromString(const std::string & stringIndex, size_t * longIn
     {
         lIndex = 0;
     }
+    else if (signedIndex < 0)
+    {
+        //
+        // Fail if the offset reaches before the start of the list.
+        //
+
+        if ((uint64_t) -(signedIndex + 1) >= Count())
+        {
+            return false;
+        }
+
+        lIndex = Count() - (size_t) -(signedIndex + 1) - 1;
+    }
     else
     {
         //
@@ -1440,10 +1831,12 @@ bool List::IndexValueFromString(const std::string & stringIndex, size_t * longIn
         // end, treat this as an append.
         //
 
-        if ((size_t) lIndex > Count())
+        if ((uint64_t) signedIndex > Count())
         {
             return false;
         }
+
+        lIndex = (size_t) signedIndex;
     }
 
     //
@@ -1458,11 +1851,60 @@ bool List::IndexValueFromString(const std::string & stringIndex, size_t * longIn
     return true;
 }
 
+//
+// Convert a null terminated index value.
+//
+
+bool List::IndexValueFromString(const char * index, size_t * longIndex) const
+{
+    return (index != nullptr) && IndexValueFromString(index, index + std::strlen(index), longIndex);
+}
+
+//
+// Convert TRUE or FALSE, in any case, or an integer to a boolean.  Return
+// true if the string could be converted and false otherwise.
+//
+
+bool List::BooleanFromString(const char * text, bool * value)
+{
+    auto trimmed = TrimView(text);
+
+    auto equals = [trimmed](std::string_view word)
+    {
+        return std::equal(trimmed.cbegin(), trimmed.cend(), word.cbegin(), word.cend(),
+                          [](char left, char right)
+                          {
+                              return std::toupper((unsigned char) left) == right;
+                          });
+    };
+
+    long long number;
+
+    if (equals("TRUE"))
+    {
+        *value = true;
+    }
+    else if (equals("FALSE"))
+    {
+        *value = false;
+    }
+    else if (ParseInteger(trimmed.data(), trimmed.data() + trimmed.size(), &number))
+    {
+        *value = number != 0;
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
 //
 // Set the delimiter for a list, returning the old value.
 //
 
-const std::string & List::Delimiter(const std::string & new_delimiter)
+const std::string & List::Delimiter(std::string_view new_delimiter)
 {
     std::string & old_delimiter(m_delimiter);
 
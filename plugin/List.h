@@ -6,10 +6,13 @@
 #include "DebugMemory.h"
 
 #include <string>
+#include <string_view>
 #include <list>
 
 #include "Types.h"
 #include "Collections.h"
+#include "CountedList.h"
+#include "ListIndex.h"
 #include "BufferManager.h"
 
 using namespace Types;
@@ -24,8 +27,8 @@ namespace Collections
         // An iterator on a list.
         //
 
-        class ListIterator : public ValueIterator<std::list<std::string>>,
-                             public ReferenceType<ListIterator, std::list<std::string>>
+        class ListIterator : public ValueIterator<CountedList<std::string>>,
+                             public ReferenceType<ListIterator>
         {
         public:
             //
@@ -45,7 +48,7 @@ namespace Collections
             // Constructor.
             //
 
-            explicit ListIterator(const std::list<std::string> & refCollection);
+            explicit ListIterator(const CountedList<std::string> & refCollection);
 
             //
             // Constructor - find a particular element, position to the end
@@ -53,8 +56,16 @@ namespace Collections
             //
 
             explicit ListIterator(
-                            const std::list<std::string> & refCollection,
-                            const std::string & refKey);
+                            const CountedList<std::string> & refCollection,
+                            std::string_view refKey);
+
+            //
+            // Constructor - position the iterator on an item already found.
+            //
+
+            explicit ListIterator(
+                            const CountedList<std::string> & refCollection,
+                            CountedList<std::string>::const_iterator position);
 
             //
             // Copy Constructor from an existing iterator.
@@ -81,42 +92,44 @@ namespace Collections
 
             static const char *GetTypeName();
 
+
             //
-            // Cloned iterators can be deleted.
+            // Clone this iterator, creating a new one.
             //
 
-            const bool CanDelete() const;
+            std::unique_ptr<ListIterator> Clone() const;
 
             //
-            // Clone this iterator, creating a new one.
+            // Return the member table that names the members to MQ2.
             //
 
-            std::unique_ptr<ListIterator> Clone() const;
+            static const MQTypeMember * GetMembers();
 
             //
-            // Return the value in the list under the current iterator.
+            // Return the member table entry for a member name or null if there
+            // is no such member.
             //
 
-            bool Value(const std::string ** const item) const;
+            static const MQTypeMember * LookupMember(const char * Name);
 
             //
             // When a member function is called on the type, this method is called.
             // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
 
             //
             // Convert the list to a string -- output the current item.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
             // This method is executed when the /varset statement is executed.  
             //
 
-            virtual bool FromString(MQVarPtr& VarPtr, const char* Source) override;
+            static bool AssignFromString(MQVarPtr& VarPtr, const char* Source);
 
             //
             // Used by the testing framework to call GetMember through the
@@ -132,16 +145,10 @@ namespace Collections
             // false if the key is not found.
             //
 
-            bool Find(const std::string & refKey);
+            bool Find(std::string_view refKey);
 
         private:
 
-            //
-            // Internal character buffer for an iterated item to return.
-            //
-
-            BufferManager<char> m_Buffer;
-
             //
             // Map from member ids onto names.
             //
@@ -152,13 +159,11 @@ namespace Collections
         //
         // A list is a flexible sequence of items.  Items can be inserted
         // anywhere in the sequence and arbitrary slices may be retrieved.
+        // The items are kept in a CountedList, so finding, inserting or
+        // erasing the item at an index is O(log n).
         //
 
-        class List : public Collection <
-                                std::list<std::string>,
-                                std::string,
-                                std::string,
-                                ValueIterator<std::list<std::string>>>,
+        class List : public Collection<CountedList<std::string>, ListIterator>,
                     public ObjectType<List>
         {
         public:
@@ -187,7 +192,10 @@ namespace Collections
                 Head,
                 Tail,
                 CountOf,
-                Delimiter
+                Delimiter,
+                Indexed,
+                RemoveAll,
+                ReplaceMany
             };
 
             //
@@ -202,6 +210,13 @@ namespace Collections
 
             List(const std::list<std::string> & source);
 
+            //
+            // Create a new list from a range of another list.
+            //
+
+            List(CountedList<std::string>::const_iterator first,
+                 CountedList<std::string>::const_iterator last);
+
             //
             // Destructor.
             //
@@ -226,7 +241,7 @@ namespace Collections
             // Return true if an item is in the list.
             //
 
-            bool Contains(const std::string & item) const;
+            bool Contains(std::string_view item) const;
 
             //
             // Return a splice of a list from a starting index to the end.  If position is beyond
@@ -247,7 +262,7 @@ namespace Collections
             // match item then the index of only the first is returned.
             //
 
-            long Index(const std::string & item) const;
+            long Index(std::string_view item) const;
 
             //
             // Retrieve the item at position index in the list.  True is
@@ -285,11 +300,26 @@ namespace Collections
                 // list before the iterator.
                 //
 
-                m_coll.insert(it, sequence.cbegin(), sequence.cend());
+                CountedList<std::string>::const_iterator first = m_coll.insert(it, sequence.cbegin(), sequence.cend());
+                ForgetCursor();
+
+                if (m_index)
+                {
+                    for (; first != it; ++first)
+                    {
+                        m_index->Inserted(m_coll, first);
+                    }
+                }
 
                 return true;
             }
 
+            //
+            // Delete every item in the list.
+            //
+
+            void Clear();
+
             //
             // Sort the list into ascending order.  The list is altered in
             // place.
@@ -308,14 +338,14 @@ namespace Collections
             // Append an item to the end of the list.
             //
 
-            void Append(const std::string & item);
+            void Append(std::string_view item);
 
             //
             // Remove an element from the list.   Return a count of the
             // number of items that matched item.
             //
 
-            size_t Remove(const std::string & item);
+            size_t Remove(std::string_view item);
 
             //
             // Erase an item at a position in the list.  Return true if the
@@ -329,13 +359,13 @@ namespace Collections
             // of items replaced.
             //
 
-            size_t Replace(const std::string & item, const std::string & newItem);
+            size_t Replace(std::string_view item, std::string_view newItem);
 
             //
             // Return an iterator to a requested key or to the end of the list.
             //
 
-            ValueIterator<std::list<std::string>> * Find(const std::string & refKey);
+            ListIterator * Find(std::string_view refKey);
 
             //
             // Remove and return the head of the list.  Return true if there
@@ -344,6 +374,12 @@ namespace Collections
 
             bool Head(std::unique_ptr<const std::string> * item);
 
+            //
+            // As above, but move the head into *item instead of copying it.
+            //
+
+            bool Head(std::string * item);
+
             //
             // Remove and return the tail of the list.  Return true if there
             // was a tail and false otherwise.
@@ -351,31 +387,66 @@ namespace Collections
 
             bool Tail(std::unique_ptr<const std::string> * item);
 
+            //
+            // As above, but move the tail into *item instead of copying it.
+            //
+
+            bool Tail(std::string * item);
+
             //
             // Return a count of how many times item occurs in the list.
             //
 
-            size_t CountOf(const std::string & item) const;
+            size_t CountOf(std::string_view item) const;
+
+            //
+            // Return true if the list keeps an index of its values.
+            //
+
+            bool IsIndexed() const;
+
+            //
+            // Start or stop keeping an index of the list's values.  An
+            // indexed list answers Contains and CountOf in O(1), and Index,
+            // Find, Remove and Replace of a value that isn't in the list
+            // without scanning it.  Each change to the list also updates the
+            // index.
+            //
+
+            void SetIndexed(bool indexed);
+
+            //
+            // Return the member table that names the members to MQ2.
+            //
+
+            static const MQTypeMember * GetMembers();
+
+            //
+            // Return the member table entry for a member name or null if there
+            // is no such member.
+            //
+
+            static const MQTypeMember * LookupMember(const char * Name);
 
             //
             // When a member function is called on the type, this method is called.
             // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
 
             //
             // Convert the list to a string -- output the count of items.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
             // This method is executed when the /varset statement is executed.  Treat
             // this as a list Append call.
             //
 
-            virtual bool FromString(MQVarPtr& VarPtr, const char* Source) override;
+            static bool AssignFromString(MQVarPtr& VarPtr, const char* Source);
 
             //
             // Used by the testing framework to call GetMember through the
@@ -384,52 +455,45 @@ namespace Collections
 
             static bool GetMemberInvoker(MQVarPtr VarPtr, PCHAR Member, PCHAR Index, MQTypeVar& Dest);
 
-        protected:
-
-            //
-            // Return an iterator on the list.
-            //
-
-            std::unique_ptr<ValueIterator<std::list<std::string>>> GetNewIterator(
-                                    const std::list<std::string> & refCollection) const;
-
         private:
 
             //
-            // Retrieve the index'th value from the list.  Return true if index
-            // is in the bounds of the list and false otherwise.
+            // Insert a sequence of items starting at index into the current
+            // list.  Return true if the items could be inserted and false otherwise.
             //
 
-            bool Item(const std::string & index, const std::string ** const item) const;
+            bool Insert(std::string_view args);
 
             //
-            // Insert a sequence of items starting at index into the current
-            // list.  Return true if the items could be inserted and false otherwise.
+            // Append a sequence of items onto the end of the list.
             //
 
-            bool Insert(const std::string & args);
+            void AppendItems(std::string_view args);
 
             //
-            // Append a sequence of items onto the end of the list.
+            // Replace a source item with a target item.  The argument must
+            // be a list of two items.  Count is set to the number of times
+            // the source was replaced by the target.  True is returned if
+            // there are two arguments and false otherwise.
             //
 
-            void AppendItems(const std::string & args);
+            bool Replace(std::string_view args, size_t * count);
 
             //
-            // Erase an index in the list.  Return true if the item was erased (deleted)
-            // and false otherwise.
+            // Remove every occurrence of each item in a sequence, in one pass
+            // over the list.  Return the number of items removed.
             //
 
-            bool Erase(const std::string & index);
+            size_t RemoveItems(std::string_view args);
 
             //
-            // Replace a source item with a target item.  The argument must
-            // be a list of two items.  Count is set to the number of times
-            // the source was replaced by the target.  True is returned if
-            // there are two arguments and false otherwise.
+            // Replace items from a sequence of source=target pairs, in one
+            // pass over the list.  Count is set to the number of items
+            // replaced.  True is returned if every pair has an = and false
+            // otherwise.
             //
 
-            bool Replace(const std::string & args, size_t * count);
+            bool ReplaceItems(std::string_view args, size_t * count);
 
             //
             // Create a splice from a set of arguments. The arguments can be of
@@ -442,29 +506,54 @@ namespace Collections
             //                          entries is returned.
             //
 
-            std::unique_ptr<List> CreateSplice(const std::string & args) const;
+            std::unique_ptr<List> CreateSplice(std::string_view args) const;
 
             //
             // Return an iterator for a position index.  Position 0 means
             // the beginning of the list.  If position is beyond the end
-            // of the list, return m_coll.end().
+            // of the list, return m_coll.end().  A position within
+            // CursorReach of the last position found or of either end of the
+            // list is reached by stepping; any other is O(log n).
             //
 
-            std::list<std::string>::const_iterator FindIteratorForPosition(size_t position) const;
+            CountedList<std::string>::const_iterator FindIteratorForPosition(size_t position) const;
+
+            //
+            // Forget the last position found.  Called by every operation
+            // that inserts, erases or moves items, since the position of the
+            // item under the cursor may have changed.
+            //
+
+            void ForgetCursor()
+            {
+                m_cursorValid = false;
+            }
 
             //
             // Convert an index value from a string.  Return true if the
-            // string could be converted and false otherwise.
+            // string could be converted and false otherwise.  A negative
+            // index counts back from the end of the list.
             //
 
-            bool IndexValueFromString(const std::string & stringIndex,
+            bool IndexValueFromString(const char * first,
+                                      const char * last,
                                       size_t * longIndex) const;
 
+            bool IndexValueFromString(const char * index,
+                                      size_t * longIndex) const;
+
+            //
+            // Convert TRUE, FALSE or an integer to a boolean.  Return true
+            // if the string could be converted and false otherwise.
+            //
+
+            static bool BooleanFromString(const char * text, bool * value);
+
             //
             // Set the delimiter for a list, returning the old value.
             //
 
-            const std::string & Delimiter(const std::string & new_delimiter);
+            const std::string & Delimiter(std::string_view new_delimiter);
 
             //
             // Delimiter used to separate items in a sequence.
@@ -473,16 +562,28 @@ namespace Collections
             std::string m_delimiter;
 
             //
-            // Internal character buffer for a returned item.
+            // The last position found by FindIteratorForPosition and its item,
+            // so that a macro indexing the list in order steps from one item
+            // to the next rather than searching for each.
+            //
+
+            static const size_t CursorReach = 16;
+
+            mutable CountedList<std::string>::const_iterator m_cursor;
+            mutable size_t m_cursorPosition;
+            mutable bool m_cursorValid;
+
+            //
+            // Index of the list's values, or null if the list isn't indexed.
             //
 
-            BufferManager<char> m_Buffer;
+            std::unique_ptr<ListIndex> m_index;
 
             //
             // Iterator returned by Find operations.
             //
 
-            std::unique_ptr<ListIterator> m_findIter;
+            IteratorSlot<ListIterator> m_findIter;
 
             //
             // Map from member ids onto names.
@@ -0,0 +1,280 @@
+//
+// ListIndex.h
+//
+// Count how many times each value occurs in a List and remember where the
+// first occurrence is, so that Contains, CountOf, Index and Find don't
+// scan the list.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "CountedList.h"
+
+namespace Collections
+{
+    namespace Containers
+    {
+        //
+        // The list tells the index about every item it inserts or erases.
+        // Entries are keyed by the hash of their value, so a std::string_view
+        // argument is looked up without making a std::string from it.
+        //
+        // The first occurrence of a value is an iterator into the list,
+        // which stays valid while its item is in the list.  When that item
+        // is erased, or the list is sorted or reversed, the first occurrence
+        // is found again by a scan the next time it is asked for.
+        //
+
+        class ListIndex
+        {
+        public:
+
+            typedef CountedList<std::string>::const_iterator const_iterator;
+
+            //
+            // Index every item in a list, replacing anything indexed before.
+            //
+
+            void Build(const CountedList<std::string> & list)
+            {
+                m_entries.clear();
+                m_entries.reserve(list.size());
+
+                for (auto item = list.cbegin(); item != list.cend(); ++item)
+                {
+                    size_t hash = Hash(*item);
+                    auto entry = Locate(m_entries, hash, *item);
+
+                    if (entry == m_entries.end())
+                    {
+                        m_entries.emplace(hash, Entry { *item, 1, item, true });
+                    }
+                    else
+                    {
+                        ++entry->second.Count;
+                    }
+                }
+            }
+
+            //
+            // Forget every value.
+            //
+
+            void Clear()
+            {
+                m_entries.clear();
+            }
+
+            //
+            // Return how many times value occurs in the list.
+            //
+
+            size_t CountOf(std::string_view value) const
+            {
+                auto entry = Locate(m_entries, Hash(value), value);
+
+                return (entry == m_entries.end()) ? 0 : entry->second.Count;
+            }
+
+            //
+            // Return the first occurrence of value in list or list.cend() if
+            // there isn't one.
+            //
+
+            const_iterator Find(const CountedList<std::string> & list, std::string_view value)
+            {
+                auto entry = Locate(m_entries, Hash(value), value);
+
+                if (entry == m_entries.end())
+                {
+                    return list.cend();
+                }
+
+                if (!entry->second.FirstKnown)
+                {
+                    entry->second.First = std::find(list.cbegin(), list.cend(), value);
+                    entry->second.FirstKnown = true;
+                }
+
+                return entry->second.First;
+            }
+
+            //
+            // Count an item that has just been inserted into list.
+            //
+
+            void Inserted(const CountedList<std::string> & list, const_iterator item)
+            {
+                size_t hash = Hash(*item);
+                auto entry = Locate(m_entries, hash, *item);
+
+                if (entry == m_entries.end())
+                {
+                    m_entries.emplace(hash, Entry { *item, 1, item, true });
+                    return;
+                }
+
+                Entry & found = entry->second;
+
+                ++found.Count;
+
+                //
+                // An appended item can't come before the first occurrence, so
+                // only an item inserted into the list needs its position
+                // compared.
+                //
+
+                auto next = std::next(item);
+
+                if (found.FirstKnown
+                    && (next != list.cend())
+                    && ((next == found.First) || (list.index_of(item) < list.index_of(found.First))))
+                {
+                    found.First = item;
+                }
+            }
+
+            //
+            // Uncount an item that is about to be erased from the list.
+            //
+
+            void Erasing(const_iterator item)
+            {
+                auto entry = Locate(m_entries, Hash(*item), *item);
+
+                if (entry == m_entries.end())
+                {
+                    return;
+                }
+
+                if (--entry->second.Count == 0)
+                {
+                    m_entries.erase(entry);
+                }
+                else if (entry->second.FirstKnown && (entry->second.First == item))
+                {
+                    entry->second.FirstKnown = false;
+                }
+            }
+
+            //
+            // Forget a value whose every occurrence has been removed from the
+            // list.
+            //
+
+            void Removed(std::string_view value)
+            {
+                auto entry = Locate(m_entries, Hash(value), value);
+
+                if (entry != m_entries.end())
+                {
+                    m_entries.erase(entry);
+                }
+            }
+
+            //
+            // Every occurrence of value in list has been replaced by
+            // newValue.  Move value's count to newValue.
+            //
+
+            void Replaced(const CountedList<std::string> & list, std::string_view value, std::string_view newValue)
+            {
+                auto entry = Locate(m_entries, Hash(value), value);
+
+                if ((entry == m_entries.end()) || (value == newValue))
+                {
+                    return;
+                }
+
+                Entry replaced = std::move(entry->second);
+
+                m_entries.erase(entry);
+
+                size_t hash = Hash(newValue);
+                auto target = Locate(m_entries, hash, newValue);
+
+                if (target == m_entries.end())
+                {
+                    replaced.Value.assign(newValue);
+                    m_entries.emplace(hash, std::move(replaced));
+                    return;
+                }
+
+                Entry & found = target->second;
+
+                found.Count += replaced.Count;
+
+                if (!replaced.FirstKnown)
+                {
+                    found.FirstKnown = false;
+                }
+                else if (found.FirstKnown && (list.index_of(replaced.First) < list.index_of(found.First)))
+                {
+                    found.First = replaced.First;
+                }
+            }
+
+            //
+            // The list has been sorted or reversed, so the first occurrences
+            // may have moved.
+            //
+
+            void Reordered()
+            {
+                for (auto & entry : m_entries)
+                {
+                    entry.second.FirstKnown = false;
+                }
+            }
+
+        private:
+
+            struct Entry
+            {
+                std::string Value;
+                size_t Count;
+                const_iterator First;
+                bool FirstKnown;
+            };
+
+            typedef std::unordered_multimap<size_t, Entry> Entries;
+
+            static size_t Hash(std::string_view value)
+            {
+                return std::hash<std::string_view>()(value);
+            }
+
+            //
+            // Return the entry for value, which hashes to hash, or
+            // entries.end().
+            //
+
+            template <typename EntryMap>
+            static auto Locate(EntryMap & entries, size_t hash, std::string_view value) -> decltype(entries.begin())
+            {
+                auto range = entries.equal_range(hash);
+
+                for (auto entry = range.first; entry != range.second; ++entry)
+                {
+                    if (entry->second.Value == value)
+                    {
+                        return entry;
+                    }
+                }
+
+                return entries.end();
+            }
+
+            Entries m_entries;
+        };
+    }  // namespace Containers
+}  // namespace Collections
@@ -24,10 +24,300 @@
 
 #include "DebugMemory.h"
 #include "MQ2CollectionsImpl.h"
+#include "AllocationAccounting.h"
+#include "ArgumentCache.h"
+#include "ChromeTrace.h"
+#include "Statistics.h"
+#include "Trace.h"
+#include "List.h"
+#include "Map.h"
+#include "Set.h"
+
+#include <algorithm>
+#include <vector>
 
 PreSetup("MQ2Collections");
 PLUGIN_VERSION(1.2);
 
+//
+// Start or stop recording a trace of the member calls made on the
+// collection types:
+//
+//  /collections trace start [file]
+//  /collections trace stop
+//
+// The trace is written to MQ2Collections.trace in the logs folder when no
+// file is given.
+//
+
+static void TraceCommand(const char * szLine)
+{
+    char szAction[MAX_STRING] = { 0 };
+    char szFile[MAX_STRING] = { 0 };
+
+    GetArg(szAction, szLine, 2);
+    GetArg(szFile, szLine, 3);
+
+    if (_stricmp(szAction, "start") == 0)
+    {
+        if (szFile[0] == '\0')
+        {
+            sprintf_s(szFile, "%s\\MQ2Collections.trace", gPathLogs);
+        }
+
+        if (Diagnostics::TraceRecorder::Start(szFile))
+        {
+            WriteChatf("MQ2Collections: recording member calls to %s", szFile);
+        }
+        else
+        {
+            WriteChatf("MQ2Collections: can't start a trace to %s", szFile);
+        }
+    }
+    else if (_stricmp(szAction, "stop") == 0)
+    {
+        if (Diagnostics::TraceRecorder::Recording())
+        {
+            WriteChatf("MQ2Collections: trace stopped, %llu records written",
+                       Diagnostics::TraceRecorder::Stop());
+        }
+        else
+        {
+            WriteChatf("MQ2Collections: no trace is being recorded");
+        }
+    }
+    else
+    {
+        WriteChatf("Usage: /collections trace start [file] | stop");
+    }
+}
+
+//
+// Control the attribution of heap allocations to members and show the
+// counts:
+//
+//  /collections allocs on|off|reset
+//  /collections allocs
+//
+
+static void AllocsCommand(const char * szLine)
+{
+    using Diagnostics::AllocationAccounting;
+
+    char szAction[MAX_STRING] = { 0 };
+
+    GetArg(szAction, szLine, 2);
+
+    if (_stricmp(szAction, "on") == 0)
+    {
+        AllocationAccounting::Enable(true);
+        WriteChatf("MQ2Collections: allocation accounting enabled");
+    }
+    else if (_stricmp(szAction, "off") == 0)
+    {
+        AllocationAccounting::Enable(false);
+        WriteChatf("MQ2Collections: allocation accounting disabled");
+    }
+    else if (_stricmp(szAction, "reset") == 0)
+    {
+        AllocationAccounting::Reset();
+        WriteChatf("MQ2Collections: allocation counts reset");
+    }
+    else if (szAction[0] == '\0')
+    {
+        auto members = AllocationAccounting::Snapshot();
+
+        std::sort(members.begin(), members.end(), [](const auto & a, const auto & b)
+        {
+            return a.Allocations > b.Allocations;
+        });
+
+        WriteChatf("MQ2Collections: allocation accounting is %s", AllocationAccounting::Enabled() ? "on" : "off");
+
+        for (const auto & member : members)
+        {
+            WriteChatf("  %s.%s: %llu calls, %llu allocs (%.2f/call), %llu bytes (%.1f/call)",
+                       member.Type,
+                       member.Member,
+                       member.Calls,
+                       member.Allocations,
+                       (double) member.Allocations / member.Calls,
+                       member.Bytes,
+                       (double) member.Bytes / member.Calls);
+        }
+    }
+    else
+    {
+        WriteChatf("Usage: /collections allocs [on | off | reset]");
+    }
+}
+
+//
+// Control the gathering of member call statistics and show them:
+//
+//  /collections stats on|off|reset
+//  /collections stats
+//
+// Members are listed by the total time spent in them.  The same figures are
+// available to macros through ${Collections}.
+//
+
+static void StatsCommand(const char * szLine)
+{
+    using Diagnostics::Statistics;
+
+    char szAction[MAX_STRING] = { 0 };
+
+    GetArg(szAction, szLine, 2);
+
+    if (_stricmp(szAction, "on") == 0)
+    {
+        Statistics::Enable(true);
+        WriteChatf("MQ2Collections: statistics enabled");
+    }
+    else if (_stricmp(szAction, "off") == 0)
+    {
+        Statistics::Enable(false);
+        WriteChatf("MQ2Collections: statistics disabled");
+    }
+    else if (_stricmp(szAction, "reset") == 0)
+    {
+        Statistics::Reset();
+        Collections::ArgumentCache::ResetCounts();
+        WriteChatf("MQ2Collections: statistics reset");
+    }
+    else if (szAction[0] == '\0')
+    {
+        auto members = Statistics::Members();
+
+        std::sort(members.begin(), members.end(), [](const auto & a, const auto & b)
+        {
+            return a.TotalNanoseconds > b.TotalNanoseconds;
+        });
+
+        WriteChatf("MQ2Collections: statistics are %s", Statistics::Enabled() ? "on" : "off");
+
+        for (const auto & member : members)
+        {
+            WriteChatf("  %s.%s: %llu calls, %.3f ms total, p50 %.2f us, p99 %.2f us, max %.2f us",
+                       member.Type,
+                       member.Member,
+                       member.Calls,
+                       member.TotalNanoseconds / 1e6,
+                       member.P50Nanoseconds / 1e3,
+                       member.P99Nanoseconds / 1e3,
+                       member.MaxNanoseconds / 1e3);
+        }
+
+        for (const auto & type : Statistics::HighWaterMarks())
+        {
+            WriteChatf("  %s high-water mark: %llu elements", type.Type, type.HighWaterMark);
+        }
+
+        WriteChatf("  argument cache: %llu hits, %llu misses",
+                   Collections::ArgumentCache::Hits(),
+                   Collections::ArgumentCache::Misses());
+    }
+    else
+    {
+        WriteChatf("Usage: /collections stats [on | off | reset]");
+    }
+}
+
+//
+// Capture collection operations on a timeline and save it for
+// chrome://tracing or Perfetto:
+//
+//  /collections timeline start [events]
+//  /collections timeline stop
+//  /collections timeline save [file]
+//
+// The most recent events (65536 by default) are kept.  The timeline is saved
+// to MQ2Collections.json in the logs folder when no file is given.
+//
+
+static void TimelineCommand(const char * szLine)
+{
+    using Diagnostics::ChromeTrace;
+
+    char szAction[MAX_STRING] = { 0 };
+    char szArgument[MAX_STRING] = { 0 };
+
+    GetArg(szAction, szLine, 2);
+    GetArg(szArgument, szLine, 3);
+
+    if (_stricmp(szAction, "start") == 0)
+    {
+        size_t capacity = szArgument[0] != '\0'
+                            ? (size_t) strtoul(szArgument, nullptr, 10)
+                            : ChromeTrace::DefaultCapacity;
+
+        ChromeTrace::Start(capacity);
+        WriteChatf("MQ2Collections: timeline started, keeping the last %zu events",
+                   capacity != 0 ? capacity : ChromeTrace::DefaultCapacity);
+    }
+    else if (_stricmp(szAction, "stop") == 0)
+    {
+        ChromeTrace::Stop();
+        WriteChatf("MQ2Collections: timeline stopped, %zu events captured", ChromeTrace::Size());
+    }
+    else if (_stricmp(szAction, "save") == 0)
+    {
+        if (szArgument[0] == '\0')
+        {
+            sprintf_s(szArgument, "%s\\MQ2Collections.json", gPathLogs);
+        }
+
+        if (ChromeTrace::Save(szArgument))
+        {
+            WriteChatf("MQ2Collections: %zu events saved to %s", ChromeTrace::Size(), szArgument);
+        }
+        else
+        {
+            WriteChatf("MQ2Collections: can't write the timeline to %s", szArgument);
+        }
+    }
+    else
+    {
+        WriteChatf("Usage: /collections timeline start [events] | stop | save [file]");
+    }
+}
+
+//
+// Handle the /collections command.
+//
+
+static void CollectionsCommand(SPAWNINFO * pChar, char * szLine)
+{
+    char szCommand[MAX_STRING] = { 0 };
+
+    GetArg(szCommand, szLine, 1);
+
+    if (_stricmp(szCommand, "trace") == 0)
+    {
+        TraceCommand(szLine);
+    }
+    else if (_stricmp(szCommand, "allocs") == 0)
+    {
+        AllocsCommand(szLine);
+    }
+    else if (_stricmp(szCommand, "stats") == 0)
+    {
+        StatsCommand(szLine);
+    }
+    else if (_stricmp(szCommand, "timeline") == 0)
+    {
+        TimelineCommand(szLine);
+    }
+    else
+    {
+        WriteChatf("Usage: /collections trace start [file] | stop");
+        WriteChatf("       /collections allocs [on | off | reset]");
+        WriteChatf("       /collections stats [on | off | reset]");
+        WriteChatf("       /collections timeline start [events] | stop | save [file]");
+    }
+}
+
 //
 // Called once, when the plugin is to loaded. Register the types.
 //
@@ -37,6 +327,8 @@ PLUGIN_API VOID InitializePlugin(VOID)
     DebugSpewAlways("Initializing MQ2Collections");
 
     RegisterTypes();
+
+    AddCommand("/collections", CollectionsCommand);
 }
 
 //
@@ -47,7 +339,26 @@ PLUGIN_API VOID ShutdownPlugin(VOID)
 {
     DebugSpewAlways("Shutting down MQ2Collections");
 
+    RemoveCommand("/collections");
+
+    Diagnostics::TraceRecorder::Stop();
+
     UnregisterTypes();
 
+    //
+    // Return the storage kept for recycling iterators to the heap, so that
+    // the leak dump doesn't report it.
+    //
+
+    Utilities::Pools::ObjectPool<Collections::Containers::ListIterator>::Trim();
+    Utilities::Pools::ObjectPool<Collections::Containers::SetIterator>::Trim();
+    Utilities::Pools::ObjectPool<Collections::Containers::MapIterator>::Trim();
+
+    //
+    // And the split arguments remembered by the argument cache.
+    //
+
+    Collections::ArgumentCache::Clear();
+
     _CrtDumpMemoryLeaks();
 }
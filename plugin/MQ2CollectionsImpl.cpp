@@ -7,8 +7,10 @@
 #include "Queue.h"
 #include "Map.h"
 #include "List.h"
+#include "CollectionsInfo.h"
 
 using namespace Collections::Containers;
+using namespace Diagnostics;
 using namespace Types;
 
 //
@@ -25,6 +27,7 @@ void RegisterTypes(void)
     Map::RegisterType();
     ListIterator::RegisterType();
     List::RegisterType();
+    CollectionsInfo::RegisterType();
 }
 
 //
@@ -33,6 +36,7 @@ void RegisterTypes(void)
 
 void UnregisterTypes(void)
 {
+    CollectionsInfo::UnregisterType();
     List::UnregisterType();
     ListIterator::UnregisterType();
     Map::UnregisterType();
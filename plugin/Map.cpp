@@ -4,8 +4,12 @@
 //
 
 
+#include <iterator>
+
 #include "Map.h"
+#include "MemberDispatch.h"
 #include "StringExtensions.h"
+#include "ArgumentCache.h"
 #include "Conversions.h"
 
 using namespace Collections::Containers;
@@ -16,7 +20,7 @@ using namespace Extensions::Strings;
 // contain a null string pointer.
 //
 
-const MQTypeMember MapIterator::MapIteratorMembers[] =
+constexpr MQTypeMember MapIterator::MapIteratorMembers[] =
 {
     { (DWORD) MapIteratorMembers::Reset, "Reset" },
     { (DWORD) MapIteratorMembers::Advance, "Advance" },
@@ -32,7 +36,7 @@ const MQTypeMember MapIterator::MapIteratorMembers[] =
 // string pointer.
 //
 
-const MQTypeMember Map::MapMembers[] =
+constexpr MQTypeMember Map::MapMembers[] =
 {
     { (DWORD) MapMembers::Count, "Count" },
     { (DWORD) MapMembers::Clear, "Clear" },
@@ -52,9 +56,8 @@ const MQTypeMember Map::MapMembers[] =
 // Constructor.
 //
 
-MapIterator::MapIterator(const std::map<std::string, std::string> & refCollection)
-    : KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>(refCollection),
-      ReferenceType(MapIteratorMembers)
+MapIterator::MapIterator(const std::map<std::string, std::string, std::less<>> & refCollection)
+    : KeyValueIterator<std::map<std::string, std::string, std::less<>>, std::string, std::string>(refCollection)
 {
 }
 
@@ -64,10 +67,9 @@ MapIterator::MapIterator(const std::map<std::string, std::string> & refCollectio
 //
 
 MapIterator::MapIterator(
-                    const std::map<std::string, std::string> & refCollection,
-                    const std::string & refKey)
-    : KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>(refCollection),
-      ReferenceType(MapIteratorMembers)
+                    const std::map<std::string, std::string, std::less<>> & refCollection,
+                    std::string_view refKey)
+    : KeyValueIterator<std::map<std::string, std::string, std::less<>>, std::string, std::string>(refCollection)
 {
     //
     // Position the iterator to the item or to the end of the
@@ -82,8 +84,7 @@ MapIterator::MapIterator(
 //
 
 MapIterator::MapIterator(const MapIterator & original)
-    : KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>(original),
-      ReferenceType(MapIteratorMembers)
+    : KeyValueIterator<std::map<std::string, std::string, std::less<>>, std::string, std::string>(original)
 {
 }
 
@@ -104,15 +105,6 @@ const char *MapIterator::GetTypeName()
     return "mapiterator";
 }
 
-//
-// Cloned iterators can be deleted.
-//
-
-const bool MapIterator::CanDelete() const
-{
-    return Cloned();
-}
-
 //
 // Clone this iterator, creating a new one.
 //
@@ -123,41 +115,24 @@ std::unique_ptr<MapIterator> MapIterator::Clone() const
 }
 
 //
-// Return the value in the map under the current iterator.  
+// Return the member table that names the members to MQ2.
 //
 
-bool MapIterator::Value(const std::string ** const item) const
+const MQTypeMember * MapIterator::GetMembers()
 {
-    //
-    // Return false if we are after the end of the set.
-    //
-
-    if (IsEnd())
-    {
-        return false;
-    }
-
-    *item = &m_iterator->second;
-    return true;
+    return MapIteratorMembers;
 }
 
 //
-// Return the key in the map under the current iterator.  
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
 //
 
-bool MapIterator::Key(const std::string ** const key) const
+const MQTypeMember * MapIterator::LookupMember(const char * Name)
 {
-    //
-    // Return false if we are after the end of the set.
-    //
-
-    if (IsEnd())
-    {
-        return false;
-    }
+    static constexpr Types::MemberDispatch<std::size(MapIteratorMembers)> dispatch(MapIteratorMembers);
 
-    *key = &m_iterator->first;
-    return true;
+    return dispatch.Find(Name);
 }
 
 //
@@ -165,7 +140,7 @@ bool MapIterator::Key(const std::string ** const key) const
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool MapIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest)
+bool MapIterator::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest)
 {
     MapIterator *pThis;
     MQTypeVar typeVar;
@@ -182,7 +157,7 @@ bool MapIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQ
     // Map the member name to the id.
     //
 
-    auto pMember = MapIterator::FindMember(Member);
+    auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -241,7 +216,7 @@ bool MapIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQ
 
             if (pThis->Value(&pItem))
             {
-                Dest.Ptr = (PVOID)pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                Dest.Ptr = (PVOID) pItem->c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -254,7 +229,7 @@ bool MapIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQ
 
             if (pThis->Key(&pItem))
             {
-                Dest.Ptr = (PVOID) pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                Dest.Ptr = (PVOID) pItem->c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -355,7 +330,7 @@ bool MapIterator::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // Return false because this operation is not supported.
 //
 
-bool MapIterator::FromString(MQVarPtr &VarPtr, const char* Source)
+bool MapIterator::AssignFromString(MQVarPtr &VarPtr, const char* Source)
 {
     return false;
 }
@@ -364,7 +339,7 @@ bool MapIterator::FromString(MQVarPtr &VarPtr, const char* Source)
 // false if the key is not found.
 //
 
-bool MapIterator::Find(const std::string & refKey)
+bool MapIterator::Find(std::string_view refKey)
 {
     m_iterator = m_refCollection.find(refKey);
 
@@ -380,7 +355,6 @@ bool MapIterator::Find(const std::string & refKey)
 //
 
 Map::Map()
-    : ObjectType(MapMembers)
 {
 }
 
@@ -405,7 +379,7 @@ const char *Map::GetTypeName()
 // Return true if a key is in the collection.
 //
 
-bool Map::Contains(const std::string &key) const
+bool Map::Contains(std::string_view key) const
 {
     return m_coll.find(key) != m_coll.end();
 }
@@ -415,9 +389,21 @@ bool Map::Contains(const std::string &key) const
 // value is overwritten.
 //
 
-void Map::Add(const std::string &key, const std::string &item)
+void Map::Add(std::string_view key, std::string_view item)
 {
-    m_coll[key] = item;
+    //
+    // Only make a key string if the key isn't already in the map.
+    //
+
+    auto it = m_coll.lower_bound(key);
+    if ((it != m_coll.end()) && (it->first == key))
+    {
+        it->second.assign(item);
+    }
+    else
+    {
+        m_coll.emplace_hint(it, std::string(key), std::string(item));
+    }
 }
 
 //
@@ -425,14 +411,15 @@ void Map::Add(const std::string &key, const std::string &item)
 // in the map.
 //
 
-bool Map::Remove(const std::string &item)
+bool Map::Remove(std::string_view item)
 {
-    if (!Contains(item))
+    auto it = m_coll.find(item);
+    if (it == m_coll.end())
     {
         return false;
     }
 
-    m_coll.erase(item);
+    m_coll.erase(it);
     return true;
 }
 
@@ -440,12 +427,30 @@ bool Map::Remove(const std::string &item)
 // Return an iterator to a requested key or to the end of the set.
 //
 
-KeyValueIterator<std::map<std::string, std::string>, std::string, std::string> * Map::Find(
-                                const std::string & refKey)
+MapIterator * Map::Find(std::string_view refKey)
+{
+    return m_findIter.Reset(std::make_unique<MapIterator>(m_coll, refKey));
+}
+
+//
+// Return the member table that names the members to MQ2.
+//
+
+const MQTypeMember * Map::GetMembers()
+{
+    return MapMembers;
+}
+
+//
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
+//
+
+const MQTypeMember * Map::LookupMember(const char * Name)
 {
-    m_findIter = std::make_unique<MapIterator>(m_coll, refKey);
+    static constexpr Types::MemberDispatch<std::size(MapMembers)> dispatch(MapMembers);
 
-    return m_findIter.get();
+    return dispatch.Find(Name);
 }
 
 //
@@ -453,7 +458,7 @@ KeyValueIterator<std::map<std::string, std::string>, std::string, std::string> *
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool Map::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest)
+bool Map::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest)
 {
     Map *pThis;
     MQTypeVar iteratorTypeVar;
@@ -470,7 +475,7 @@ bool Map::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
     // Map the member name to the id.
     //
 
-    auto pMember = Map::FindMember(Member);
+    auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -522,7 +527,7 @@ bool Map::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Contains(std::string(Index));
+                Dest.Int = (int) pThis->Contains(Index);
             }
             break;
 
@@ -553,7 +558,7 @@ bool Map::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Remove(std::string(Index));
+                Dest.Int = (int) pThis->Remove(Index);
             }
             break;
 
@@ -583,7 +588,7 @@ bool Map::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Ptr = (PVOID) pThis->Find(std::string(Index));
+                Dest.Ptr = (PVOID) pThis->Find(Index);
 
                 //
                 // Get the MapIterator type and return it.
@@ -625,22 +630,12 @@ bool Map::ToString(MQVarPtr VarPtr, PCHAR Destination)
     return rc == 0;
 }
 
-//
-// Return an iterator on the map.
-//
-
-std::unique_ptr<KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>> Map::GetNewIterator(
-    const std::map<std::string, std::string> & refCollection) const
-{
-    return std::make_unique<MapIterator>(refCollection);
-}
-
 //
 // This method is executed when the /varset statement is executed.  Ignore
 // this call.
 //
 
-bool Map::FromString(MQVarPtr &VarPtr, const char* Source)
+bool Map::AssignFromString(MQVarPtr &VarPtr, const char* Source)
 {
     return false;
 }
@@ -662,17 +657,17 @@ bool Map::AddKeyAndValue(Map * pThis, PCHAR Arguments)
 
     //
     // Split the arguments and add the first one as the key and
-    // the second as the value.
+    // the second as the value, both trimmed.  A recently seen argument
+    // isn't split again.
     //
 
-    auto argument = std::make_unique<StringExtensions>(Arguments);
-    auto splits = argument->Split(StringExtensions::string_type(","));
+    const auto & splits = ArgumentCache::Split(GetTypeName(), "Add", Arguments, ",", true);
 
     //
     // There must be two and only two arguments.
     //
 
-    if (splits->size() != 2)
+    if (splits.size() != 2)
     {
         //
         // Generate an error because we have the incorrect number
@@ -683,28 +678,20 @@ bool Map::AddKeyAndValue(Map * pThis, PCHAR Arguments)
     }
     else
     {
-        //
-        // Trim the key and value.
-        //
-
-        auto arg = std::make_unique<StringExtensions>((*splits)[0]);
-        auto key = arg->Trim();
-
-        arg = std::make_unique<StringExtensions>((*splits)[1]);
-        auto value = arg->Trim();
-
+        const auto & key = splits[0];
+        const auto & value = splits[1];
 
         //
         // Neither the key nor the value can be empty.
         //
 
-        if ((key->Contents().length() == 0) || (value->Contents().length() == 0))
+        if ((key.length() == 0) || (value.length() == 0))
         {
             fResult = false;
         }
         else
         {
-            pThis->Add(key->Contents(), value->Contents());
+            pThis->Add(key, value);
         }
     }
 
@@ -6,6 +6,8 @@
 #include "DebugMemory.h"
 
 #include <string>
+#include <string_view>
+#include <functional>
 #include <map>
 
 #include "Types.h"
@@ -24,8 +26,8 @@ namespace Collections
         // An iterator on a map.
         //
 
-        class MapIterator : public KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>,
-                            public ReferenceType<MapIterator, std::map<std::string, std::string>>
+        class MapIterator : public KeyValueIterator<std::map<std::string, std::string, std::less<>>, std::string, std::string>,
+                            public ReferenceType<MapIterator>
         {
         public:
             //
@@ -46,7 +48,7 @@ namespace Collections
             // Constructor.
             //
 
-            explicit MapIterator(const std::map<std::string, std::string> & refCollection);
+            explicit MapIterator(const std::map<std::string, std::string, std::less<>> & refCollection);
 
             //
             // Constructor - find a particular element, position to the end
@@ -54,8 +56,8 @@ namespace Collections
             //
 
             explicit MapIterator(
-                            const std::map<std::string, std::string> & refCollection,
-                            const std::string & refKey);
+                            const std::map<std::string, std::string, std::less<>> & refCollection,
+                            std::string_view refKey);
 
             //
             // Copy Constructor from an existing iterator.
@@ -82,48 +84,44 @@ namespace Collections
 
             static const char *GetTypeName();
 
-            //
-            // Cloned iterators can be deleted.
-            //
-
-            const bool CanDelete() const;
 
             //
-            // Return the value in the map under the current iterator.  
+            // Clone this iterator, creating a new one.
             //
 
-            bool Value(const std::string ** const item) const;
+            std::unique_ptr<MapIterator> Clone() const;
 
             //
-            // Return the key in the map under the current iterator.  
+            // Return the member table that names the members to MQ2.
             //
 
-            bool Key(const std::string ** const key) const;
+            static const MQTypeMember * GetMembers();
 
             //
-            // Clone this iterator, creating a new one.
+            // Return the member table entry for a member name or null if there
+            // is no such member.
             //
 
-            std::unique_ptr<MapIterator> Clone() const;
+            static const MQTypeMember * LookupMember(const char * Name);
 
             //
             // When a member function is called on the type, this method is called.
             // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest);
 
             //
             // Convert the map to a string -- output the current item.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
             // This method is executed when the /varset statement is executed.  
             //
 
-            virtual bool FromString(MQVarPtr &VarPtr, const char* Source) override;
+            static bool AssignFromString(MQVarPtr &VarPtr, const char* Source);
 
         protected:
 
@@ -132,16 +130,10 @@ namespace Collections
             // false if the key is not found.
             //
 
-            bool Find(const std::string & refKey);
+            bool Find(std::string_view refKey);
 
         private:
 
-            //
-            // Internal character buffer for an iterated item to return.
-            //
-
-            BufferManager<char> m_Buffer;
-
             //
             // Map from member ids onto names.
             //
@@ -154,12 +146,11 @@ namespace Collections
         // A map is a collection that associates a key with a value.  There is
         // only one of each key in the map.
         //
+        // The map's comparator is std::less<>, so a key can be looked up
+        // with a std::string_view without making a std::string.
+        //
 
-        class Map : public Collection<
-                            std::map<std::string, std::string>,
-                            std::string,
-                            std::string,
-                            KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>>,
+        class Map : public Collection<std::map<std::string, std::string, std::less<>>, MapIterator>,
                     public ObjectType<Map>
         {
         public:
@@ -209,57 +200,60 @@ namespace Collections
             // Return true if a key is in the collection.
             //
 
-            bool Contains(const std::string &key) const;
+            bool Contains(std::string_view key) const;
 
             //
             // Add a new element to the map.  If he key already exists, the
             // value is overwritten.
             //
 
-            void Add(const std::string &key, const std::string &item);
+            void Add(std::string_view key, std::string_view item);
 
             //
             // Remove an element from the map.  Return false if the item was not
             // in the map.
             //
 
-            bool Remove(const std::string &item);
+            bool Remove(std::string_view item);
 
             //
             // Return an iterator to a requested key or to the end of the map.
             //
 
-            KeyValueIterator<std::map<std::string, std::string>, std::string, std::string> * Find(
-                                const std::string & refKey);
+            MapIterator * Find(std::string_view refKey);
 
             //
-            // When a member function is called on the type, this method is called.
-            // It returns true if the method succeeded and false otherwise.
+            // Return the member table that names the members to MQ2.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override;
+            static const MQTypeMember * GetMembers();
 
             //
-            // Convert the map to a string -- output the count of items.
+            // Return the member table entry for a member name or null if there
+            // is no such member.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static const MQTypeMember * LookupMember(const char * Name);
 
             //
-            // This method is executed when the /varset statement is executed.
-            // Ignore the call.
+            // When a member function is called on the type, this method is called.
+            // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool FromString(MQVarPtr& VarPtr, const char* Source) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
 
-        protected:
+            //
+            // Convert the map to a string -- output the count of items.
+            //
+
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
-            // Return an iterator on the map.
+            // This method is executed when the /varset statement is executed.
+            // Ignore the call.
             //
 
-            std::unique_ptr<KeyValueIterator<std::map<std::string, std::string>, std::string, std::string>> GetNewIterator(
-                    const std::map<std::string, std::string> & refCollection) const;
+            static bool AssignFromString(MQVarPtr& VarPtr, const char* Source);
 
         private:
 
@@ -268,13 +262,13 @@ namespace Collections
             // added and false otherwise.
             //
 
-            bool AddKeyAndValue(Map * pThis, PCHAR Arguments);
+            static bool AddKeyAndValue(Map * pThis, PCHAR Arguments);
 
             //
             // Iterator returned by Find operations.
             //
 
-            std::unique_ptr<MapIterator> m_findIter;
+            IteratorSlot<MapIterator> m_findIter;
 
             //
             // Map from member ids onto names.
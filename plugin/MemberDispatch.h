@@ -0,0 +1,163 @@
+//
+// MemberDispatch.h
+//
+// Resolve member names to member table entries with a perfect hash that is
+// computed at compile time, so a member call doesn't search the MQ2 member
+// map or take the lock that guards it.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#include "HostTypes.h"
+
+namespace Types
+{
+    //
+    // A perfect hash over a null terminated member table of Count entries
+    // (including the terminator).  Every name in the table hashes to its
+    // own slot; a lookup hashes the name, then compares it with the one
+    // entry in that slot.  Names are compared without regard to case, as
+    // MQ2 does.
+    //
+    // Define the member table constexpr and build the dispatch where the
+    // table is accessible:
+    //
+    //     constexpr MQTypeMember List::ListMembers[] = { ... { 0, 0 } };
+    //
+    //     static constexpr MemberDispatch<std::size(ListMembers)> dispatch(ListMembers);
+    //
+    // The constructor fails to compile if no seed yields a perfect hash.
+    //
+
+    template <size_t Count>
+    class MemberDispatch
+    {
+    public:
+
+        constexpr explicit MemberDispatch(const MQTypeMember (&members)[Count])
+            : m_members(members),
+              m_seed(0),
+              m_slots {}
+        {
+            for (uint32_t seed = 1; seed != MaximumSeed; ++seed)
+            {
+                if (TrySeed(seed))
+                {
+                    return;
+                }
+            }
+
+            //
+            // Not a constant expression: no perfect hash was found.
+            //
+
+            throw "No perfect hash for the member table.";
+        }
+
+        //
+        // Return the member table entry for a name or null if the type has
+        // no such member.
+        //
+
+        const MQTypeMember * Find(const char * name) const
+        {
+            if (name == nullptr)
+            {
+                return nullptr;
+            }
+
+            uint8_t slot = m_slots[Hash(name, m_seed) & (TableSize - 1)];
+            if (slot == 0)
+            {
+                return nullptr;
+            }
+
+            const MQTypeMember * member = &m_members[slot - 1];
+
+            return SameName(member->Name, name) ? member : nullptr;
+        }
+
+    private:
+
+        //
+        // Table size: the next power of two at least twice the number of
+        // members, which keeps the seed search short.
+        //
+
+        static constexpr size_t SlotCount(size_t size)
+        {
+            return size >= 2 * Count ? size : SlotCount(size * 2);
+        }
+
+        static constexpr size_t TableSize = SlotCount(8);
+        static constexpr uint32_t MaximumSeed = 1 << 16;
+
+        static_assert(Count < 256, "A slot holds the member index in a byte.");
+
+        static constexpr uint32_t Fold(char c)
+        {
+            return (c >= 'A') && (c <= 'Z') ? (uint32_t) (c - 'A' + 'a') : (uint32_t) (unsigned char) c;
+        }
+
+        //
+        // FNV-1a over the case folded name, with the seed mixed into the
+        // starting state.
+        //
+
+        static constexpr uint32_t Hash(const char * name, uint32_t seed)
+        {
+            uint32_t hash = 2166136261u ^ (seed * 0x9e3779b9u);
+
+            for (; *name != '\0'; ++name)
+            {
+                hash = (hash ^ Fold(*name)) * 16777619u;
+            }
+
+            return hash ^ (hash >> 16);
+        }
+
+        static constexpr bool SameName(const char * a, const char * b)
+        {
+            for (; (*a != '\0') && (Fold(*a) == Fold(*b)); ++a, ++b)
+            {
+            }
+
+            return Fold(*a) == Fold(*b);
+        }
+
+        //
+        // Fill the slots using a seed.  Return false if two names collide.
+        //
+
+        constexpr bool TrySeed(uint32_t seed)
+        {
+            for (size_t i = 0; i < TableSize; ++i)
+            {
+                m_slots[i] = 0;
+            }
+
+            for (size_t i = 0; m_members[i].Name != nullptr; ++i)
+            {
+                uint8_t & slot = m_slots[Hash(m_members[i].Name, seed) & (TableSize - 1)];
+
+                if (slot != 0)
+                {
+                    return false;
+                }
+
+                slot = (uint8_t) (i + 1);
+            }
+
+            m_seed = seed;
+            return true;
+        }
+
+        const MQTypeMember * m_members;
+        uint32_t m_seed;
+        uint8_t m_slots[TableSize];
+    };
+}
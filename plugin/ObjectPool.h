@@ -0,0 +1,139 @@
+//
+// ObjectPool.h
+//
+// Recycle the storage of small objects that are created and deleted often,
+// such as iterators, through a free list instead of the heap.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstddef>
+#include <new>
+
+namespace Utilities
+{
+    namespace Pools
+    {
+        //
+        // A free list of blocks the size of T.  A class uses it from its
+        // operator new and operator delete.  Up to MaximumFree blocks are
+        // kept for reuse; the rest go back to the heap.  Requests of any
+        // other size (a class derived from T) go straight to the heap.
+        //
+        // Like the type map, the pool is only used from the game thread.
+        //
+
+        template <typename T>
+        class ObjectPool
+        {
+        public:
+
+            static const size_t MaximumFree = 256;
+
+            static void * Allocate(size_t size)
+            {
+                Pool & pool = Instance();
+
+                if ((size == sizeof(T)) && (pool.m_free != nullptr))
+                {
+                    Block * block = pool.m_free;
+
+                    pool.m_free = block->Next;
+                    --pool.m_count;
+
+                    return block;
+                }
+
+                return ::operator new(size);
+            }
+
+            static void Free(void * storage, size_t size)
+            {
+                if (storage == nullptr)
+                {
+                    return;
+                }
+
+                Pool & pool = Instance();
+
+                if ((size == sizeof(T)) && (pool.m_count < MaximumFree))
+                {
+                    Block * block = static_cast<Block *>(storage);
+
+                    block->Next = pool.m_free;
+                    pool.m_free = block;
+                    ++pool.m_count;
+
+                    return;
+                }
+
+                ::operator delete(storage);
+            }
+
+            //
+            // Return the number of blocks waiting to be reused.
+            //
+
+            static size_t FreeCount()
+            {
+                return Instance().m_count;
+            }
+
+            //
+            // Return every free block to the heap.
+            //
+
+            static void Trim()
+            {
+                Instance().Clear();
+            }
+
+        private:
+
+            struct Block
+            {
+                Block * Next;
+            };
+
+            static_assert(sizeof(T) >= sizeof(Block), "T is too small to pool.");
+
+            struct Pool
+            {
+                Pool()
+                    : m_free(nullptr),
+                      m_count(0)
+                {
+                }
+
+                ~Pool()
+                {
+                    Clear();
+                }
+
+                void Clear()
+                {
+                    while (m_free != nullptr)
+                    {
+                        Block * block = m_free;
+
+                        m_free = block->Next;
+                        ::operator delete(block);
+                    }
+
+                    m_count = 0;
+                }
+
+                Block * m_free;
+                size_t m_count;
+            };
+
+            static Pool & Instance()
+            {
+                static Pool pool;
+
+                return pool;
+            }
+        };
+    }  // namespace Pools
+}  // namespace Utilities
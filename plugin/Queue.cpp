@@ -3,7 +3,10 @@
 //
 
 
+#include <iterator>
+
 #include "Queue.h"
+#include "MemberDispatch.h"
 #include "Conversions.h"
 
 using namespace Collections::Containers;
@@ -13,7 +16,7 @@ using namespace Collections::Containers;
 // pointer.
 //
 
-const MQTypeMember Queue::QueueMembers[] =
+constexpr MQTypeMember Queue::QueueMembers[] =
 {
     { (DWORD) QueueMembers::Count, "Count" },
     { (DWORD) QueueMembers::Push, "Push" },
@@ -23,16 +26,37 @@ const MQTypeMember Queue::QueueMembers[] =
     { 0, 0 }
 };
 
+//
+// Return the member table that names the members to MQ2.
+//
+
+const MQTypeMember * Queue::GetMembers()
+{
+    return QueueMembers;
+}
+
+//
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
+//
+
+const MQTypeMember * Queue::LookupMember(const char * Name)
+{
+    static constexpr Types::MemberDispatch<std::size(QueueMembers)> dispatch(QueueMembers);
+
+    return dispatch.Find(Name);
+}
+
 //
 // When a member function is called on the type, this method is called.
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool Queue::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest)
+bool Queue::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar &Dest)
 {
     Queue *pThis;
     std::string value;
-    std::unique_ptr<std::string> pValue;
+    const std::string * pValue;
 
     //
     // Default return value is FALSE.
@@ -45,7 +69,7 @@ bool Queue::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVa
     // Map the member name to the id.
     //
 
-    auto pMember = Queue::FindMember(Member);
+    auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -107,9 +131,9 @@ bool Queue::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVa
             // empty, return FALSE.
             //
 
-            if (pThis->Pop(&pValue))
+            if (pThis->Pop(&ResultSlot<Queue>::Value()))
             {
-                Dest.Ptr = (PVOID)pThis->m_Buffer.SetBuffer(pValue->c_str(), pValue->size() + 1);
+                Dest.Ptr = (PVOID) ResultSlot<Queue>::Pointer();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -131,7 +155,7 @@ bool Queue::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVa
 
             if (pThis->Peek(&pValue))
             {
-                Dest.Ptr = (PVOID)pThis->m_Buffer.SetBuffer(pValue->c_str(), pValue->size() + 1);
+                Dest.Ptr = (PVOID) pValue->c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -170,7 +194,7 @@ bool Queue::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // this as a queue Push call.
 //
 
-bool Queue::FromString(MQVarPtr &VarPtr, const char* Source)
+bool Queue::AssignFromString(MQVarPtr &VarPtr, const char* Source)
 {
     Queue *pDest;
 
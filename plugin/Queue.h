@@ -5,6 +5,7 @@
 #pragma once
 #include "DebugMemory.h"
 
+#include <memory>
 #include <string>
 #include <queue>
 
@@ -45,7 +46,6 @@ namespace Collections
             //
 
             Queue()
-                : ObjectType(QueueMembers)
             {
             }
 
@@ -99,13 +99,31 @@ namespace Collections
             //
 
             bool Pop(std::unique_ptr<std::string> *item)
+            {
+                std::string value;
+
+                if (!Pop(&value))
+                {
+                    return false;
+                }
+
+                *item = std::make_unique<std::string>(std::move(value));
+                return true;
+            }
+
+            //
+            // As above, but move the element into *item instead of copying
+            // it.
+            //
+
+            bool Pop(std::string *item)
             {
                 if (IsEmpty())
                 {
                     return false;
                 }
 
-                *item = std::make_unique<std::string>(m_coll.front());
+                *item = std::move(m_coll.front());
                 m_coll.pop();
                 return true;
             }
@@ -125,35 +143,67 @@ namespace Collections
             //
 
             bool Peek(std::unique_ptr<std::string> *item) const
+            {
+                const std::string *value;
+
+                if (!Peek(&value))
+                {
+                    return false;
+                }
+
+                *item = std::make_unique<std::string>(*value);
+                return true;
+            }
+
+            //
+            // As above, but return a pointer to the element held by the queue
+            // instead of a copy.  The pointer is valid until the element is
+            // removed.
+            //
+
+            bool Peek(const std::string **item) const
             {
                 if (IsEmpty())
                 {
                     return false;
                 }
 
-                *item = std::make_unique<std::string>(m_coll.front());
+                *item = &m_coll.front();
                 return true;
             }
 
+            //
+            // Return the member table that names the members to MQ2.
+            //
+
+            static const MQTypeMember * GetMembers();
+
+            //
+            // Return the member table entry for a member name or null if there
+            // is no such member.
+            //
+
+            static const MQTypeMember * LookupMember(const char * Name);
+
             //
             // When a member function is called on the type, this method is called.
             // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
 
             //
             // Convert the queue to a string -- output the count of items.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
             // This method is executed when the /varset statement is executed.  Treat
             // this as a queue push call.
             //
 
-            virtual bool FromString(MQVarPtr& VarPtr, const char* Source) override;
+            static bool AssignFromString(MQVarPtr& VarPtr, const char* Source);
 
         private:
 
@@ -163,12 +213,6 @@ namespace Collections
 
             std::queue<std::string> m_coll;
 
-            //
-            // Buffer containing the value of an item returned from the queue.
-            //
-
-            BufferManager<char> m_Buffer;
-
             //
             // Map from member ids onto names.
             //
@@ -3,10 +3,14 @@
 // Implementation file for SetIterator and Set.
 //
 
+#include <algorithm>
+#include <iterator>
 
 #include "Set.h"
+#include "MemberDispatch.h"
 #include "Conversions.h"
 #include "StringExtensions.h"
+#include "ArgumentCache.h"
 #include "Macros.h"
 
 using namespace Extensions::Strings;
@@ -17,7 +21,7 @@ using namespace Collections::Containers;
 // contain a null string pointer.
 //
 
-const MQTypeMember SetIterator::SetIteratorMembers[] =
+constexpr MQTypeMember SetIterator::SetIteratorMembers[] =
 {
     { (DWORD) SetIteratorMembers::Reset, "Reset" },
     { (DWORD) SetIteratorMembers::Advance, "Advance" },
@@ -32,7 +36,7 @@ const MQTypeMember SetIterator::SetIteratorMembers[] =
 // string pointer.
 //
 
-const MQTypeMember Set::SetMembers[] =
+constexpr MQTypeMember Set::SetMembers[] =
 {
     { (DWORD) SetMembers::Count, "Count" },
     { (DWORD) SetMembers::Clear, "Clear" },
@@ -51,9 +55,8 @@ const MQTypeMember Set::SetMembers[] =
             // Constructor.
             //
 
-SetIterator::SetIterator(const std::set<std::string> & refCollection)
-        : ValueIterator<std::set<std::string>>(refCollection),
-          ReferenceType(SetIteratorMembers)
+SetIterator::SetIterator(const std::set<std::string, std::less<>> & refCollection)
+        : ValueIterator<std::set<std::string, std::less<>>>(refCollection)
 {
 }
 
@@ -63,10 +66,9 @@ SetIterator::SetIterator(const std::set<std::string> & refCollection)
 //
 
 SetIterator::SetIterator(
-                const std::set<std::string> & refCollection,
-                const std::string & refKey)
-        : ValueIterator<std::set<std::string>>(refCollection),
-          ReferenceType(SetIteratorMembers)
+                const std::set<std::string, std::less<>> & refCollection,
+                std::string_view refKey)
+        : ValueIterator<std::set<std::string, std::less<>>>(refCollection)
 {
     //
     // Position the iterator to the item or to the end of the
@@ -81,8 +83,7 @@ SetIterator::SetIterator(
 //
 
 SetIterator::SetIterator(const SetIterator & original)
-        : ValueIterator<std::set<std::string>>(original),
-          ReferenceType(SetIteratorMembers)
+        : ValueIterator<std::set<std::string, std::less<>>>(original)
 {
 }
 
@@ -104,40 +105,33 @@ const char *SetIterator::GetTypeName()
 }
 
 //
-// Cloned iterators can be deleted.
+// Clone this iterator, creating a new one.
 //
 
-const bool SetIterator::CanDelete() const
+std::unique_ptr<SetIterator> SetIterator::Clone() const
 {
-    return Cloned();
+    return std::make_unique<SetIterator>(*this);
 }
 
 //
-// Clone this iterator, creating a new one.
+// Return the member table that names the members to MQ2.
 //
 
-std::unique_ptr<SetIterator> SetIterator::Clone() const
+const MQTypeMember * SetIterator::GetMembers()
 {
-    return std::make_unique<SetIterator>(*this);
+    return SetIteratorMembers;
 }
 
 //
-// Return the value in the set under the current iterator.
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
 //
 
-bool SetIterator::Value(const std::string ** const item) const
+const MQTypeMember * SetIterator::LookupMember(const char * Name)
 {
-    //
-    // Return false if we are after the end of the set.
-    //
+    static constexpr Types::MemberDispatch<std::size(SetIteratorMembers)> dispatch(SetIteratorMembers);
 
-    if (IsEnd())
-    {
-        return false;
-    }
-
-    *item = &(*m_iterator);
-    return true;
+    return dispatch.Find(Name);
 }
 
 //
@@ -145,7 +139,7 @@ bool SetIterator::Value(const std::string ** const item) const
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool SetIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+bool SetIterator::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
 {
     SetIterator *pThis;
     MQTypeVar typeVar;
@@ -162,7 +156,7 @@ bool SetIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQ
     // Map the member name to the id.
     //
 
-    auto pMember = SetIterator::FindMember(Member);
+    auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -221,7 +215,7 @@ bool SetIterator::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQ
 
             if (pThis->Value(&pItem))
             {
-                Dest.Ptr = (PVOID) pThis->m_Buffer.SetBuffer(pItem->c_str(), pItem->size() + 1);
+                Dest.Ptr = (PVOID) pItem->c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -287,7 +281,7 @@ bool SetIterator::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // Return false because this operation is not supported.
 //
 
-bool SetIterator::FromString(MQVarPtr&VarPtr, const char* Source)
+bool SetIterator::AssignFromString(MQVarPtr&VarPtr, const char* Source)
 {
     return false;
 }
@@ -297,7 +291,7 @@ bool SetIterator::FromString(MQVarPtr&VarPtr, const char* Source)
 // false if the key is not found.
 //
 
-bool SetIterator::Find(const std::string & refKey)
+bool SetIterator::Find(std::string_view refKey)
 {
     m_iterator = m_refCollection.find(refKey);
 
@@ -313,7 +307,6 @@ bool SetIterator::Find(const std::string & refKey)
 //
 
 Set::Set()
-    :ObjectType(SetMembers)
 {
 }
 
@@ -338,7 +331,7 @@ const char *Set::GetTypeName()
 // Return true if a key is in the collection.
 //
 
-bool Set::Contains(const std::string &key) const
+bool Set::Contains(std::string_view key) const
 {
     return m_coll.find(key) != m_coll.end();
 }
@@ -347,9 +340,17 @@ bool Set::Contains(const std::string &key) const
 // Add a new element to the set.
 //
 
-void Set::Add(const std::string &item)
+void Set::Add(std::string_view item)
 {
-    m_coll.insert(item);
+    //
+    // Only make a string if the item isn't already in the set.
+    //
+
+    auto it = m_coll.lower_bound(item);
+    if ((it == m_coll.end()) || (*it != item))
+    {
+        m_coll.emplace_hint(it, item);
+    }
 }
 
 //
@@ -357,14 +358,15 @@ void Set::Add(const std::string &item)
 // in the set.
 //
 
-bool Set::Remove(const std::string &item)
+bool Set::Remove(std::string_view item)
 {
-    if (!Contains(item))
+    auto it = m_coll.find(item);
+    if (it == m_coll.end())
     {
         return false;
     }
 
-    m_coll.erase(item);
+    m_coll.erase(it);
     return true;
 }
 
@@ -372,34 +374,51 @@ bool Set::Remove(const std::string &item)
 // Add a sequence of items to the set.
 //
 
-void Set::AddItems(const std::string &items)
+void Set::AddItems(std::string_view items)
 {
     //
-    // Split the string into extents.  Each extent represents an argument
-    // to insert.  An empty collection will append no strings.
+    // Split the string into extents and add each one as it is found.  A
+    // recently seen argument isn't split again.
     //
 
-    auto arguments = std::make_unique<StringExtensions>(items);
-    auto coll = arguments->Split(StringExtensions::string_type(","));
-
-    std::for_each(coll->cbegin(),
-        coll->cend(),
-        [this](const std::string & item)
-        {
-            Add(item);
-        }
-    );
+    ArgumentCache::ForEach(GetTypeName(),
+                           "Add",
+                           items,
+                           ",",
+                           [this] (std::string_view item)
+                           {
+                               Add(item);
+                           });
 }
 
 //
 // Return an iterator to a requested key or to the end of the set.
 //
 
-ValueIterator<std::set<std::string>> * Set::Find(const std::string & refKey)
+SetIterator * Set::Find(std::string_view refKey)
 {
-    m_findIter = std::make_unique<SetIterator>(m_coll, refKey);
+    return m_findIter.Reset(std::make_unique<SetIterator>(m_coll, refKey));
+}
+
+//
+// Return the member table that names the members to MQ2.
+//
+
+const MQTypeMember * Set::GetMembers()
+{
+    return SetMembers;
+}
+
+//
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
+//
+
+const MQTypeMember * Set::LookupMember(const char * Name)
+{
+    static constexpr Types::MemberDispatch<std::size(SetMembers)> dispatch(SetMembers);
 
-    return m_findIter.get();
+    return dispatch.Find(Name);
 }
 
 //
@@ -407,11 +426,11 @@ ValueIterator<std::set<std::string>> * Set::Find(const std::string & refKey)
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool Set::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+bool Set::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
 {
     Set *pThis;
     MQTypeVar iteratorTypeVar;
-    std::string value;
+    std::string_view value;
 
     //
     // Default return value is FALSE.
@@ -424,7 +443,7 @@ bool Set::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar&
     // Map the member name to the id.
     //
 
-    auto pMember = Set::FindMember(Member);
+    auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -476,7 +495,7 @@ bool Set::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar&
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Contains(std::string(Index));
+                Dest.Int = (int) pThis->Contains(Index);
             }
             break;
 
@@ -517,7 +536,7 @@ bool Set::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar&
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Int = (int) pThis->Remove(std::string(Index));
+                Dest.Int = (int) pThis->Remove(Index);
             }
             break;
 
@@ -547,7 +566,7 @@ bool Set::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar&
 
             if (NOT_EMPTY(Index))
             {
-                Dest.Ptr = (PVOID) pThis->Find(std::string(Index));
+                Dest.Ptr = (PVOID) pThis->Find(Index);
 
                 //
                 // Get the SetIterator type and return it.
@@ -592,7 +611,7 @@ bool Set::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // this as a set Add call.
 //
 
-bool Set::FromString(MQVarPtr &VarPtr, const char* Source)
+bool Set::AssignFromString(MQVarPtr &VarPtr, const char* Source)
 {
     Set *pDest;
 
@@ -604,19 +623,9 @@ bool Set::FromString(MQVarPtr &VarPtr, const char* Source)
 
     if ((pDest != nullptr) && NOT_EMPTY(Source))
     {
-        pDest->Add(std::string(Source));
+        pDest->Add(Source);
     }
 
     return true;
 }
 
-//
-// Return an iterator on the set.
-//
-
-std::unique_ptr<ValueIterator<std::set<std::string>>> Set::GetNewIterator(
-    const std::set<std::string> & refCollection) const
-{
-    return std::make_unique<SetIterator>(refCollection);
-}
-
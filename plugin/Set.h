@@ -6,6 +6,8 @@
 #include "DebugMemory.h"
 
 #include <string>
+#include <string_view>
+#include <functional>
 #include <set>
 
 #include "Types.h"
@@ -24,8 +26,8 @@ namespace Collections
         // An iterator on a set.
         //
 
-        class SetIterator : public ValueIterator<std::set<std::string>>,
-                            public ReferenceType<SetIterator, std::set<std::string>>
+        class SetIterator : public ValueIterator<std::set<std::string, std::less<>>>,
+                            public ReferenceType<SetIterator>
         {
         public:
             //
@@ -45,7 +47,7 @@ namespace Collections
             // Constructor.
             //
 
-            explicit SetIterator(const std::set<std::string> & refCollection);
+            explicit SetIterator(const std::set<std::string, std::less<>> & refCollection);
 
             //
             // Constructor - find a particular element, position to the end
@@ -53,8 +55,8 @@ namespace Collections
             //
 
             explicit SetIterator(
-                        const std::set<std::string> & refCollection,
-                        const std::string & refKey);
+                        const std::set<std::string, std::less<>> & refCollection,
+                        std::string_view refKey);
 
             //
             // Copy constructor for an existing set iterator.
@@ -81,43 +83,53 @@ namespace Collections
 
             static const char *GetTypeName();
 
+
             //
-            // Cloned iterators can be deleted.
+            // Clone this iterator, creating a new one.
             //
 
-            const bool CanDelete() const;
+            std::unique_ptr<SetIterator> Clone() const;
+
 
             //
-            // Return the value in the set under the current iterator.
+
+
+            // Return the member table that names the members to MQ2.
+
+
             //
 
-            bool Value(const std::string ** const item) const;
+
+
+            static const MQTypeMember * GetMembers();
+
+
 
             //
-            // Clone this iterator, creating a new one.
+            // Return the member table entry for a member name or null if there
+            // is no such member.
             //
 
-            std::unique_ptr<SetIterator> Clone() const;
-
+            static const MQTypeMember * LookupMember(const char * Name);
 
             //
             // When a member function is called on the type, this method is called.
             // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
 
             //
             // Convert the set to a string -- output the current item.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
             // This method is executed when the /varset statement is executed.  
             //
 
-            virtual bool FromString(MQVarPtr& VarPtr, const char* Source) override;
+            static bool AssignFromString(MQVarPtr& VarPtr, const char* Source);
 
         protected:
 
@@ -126,16 +138,10 @@ namespace Collections
             // false if the key is not found.
             //
 
-            bool Find(const std::string & refKey);
+            bool Find(std::string_view refKey);
 
         private:
 
-            //
-            // Internal character buffer for an iterated item to return.
-            //
-
-            BufferManager<char> m_Buffer;
-
             //
             // Map from member ids onto names.
             //
@@ -147,12 +153,11 @@ namespace Collections
         // A set is a collection that contains only one of each element. Adding an
         // existing element to the set produces a set with the same elements.
         //
+        // The set's comparator is std::less<>, so an element can be looked up
+        // with a std::string_view without making a std::string.
+        //
 
-        class Set : public Collection<
-                                std::set<std::string>,
-                                std::string,
-                                std::string,
-                                ValueIterator<std::set<std::string>>>,
+        class Set : public Collection<std::set<std::string, std::less<>>, SetIterator>,
                     public ObjectType<Set>
         {
         public:
@@ -202,61 +207,65 @@ namespace Collections
             // Return true if a key is in the collection.
             //
 
-            bool Contains(const std::string &key) const;
+            bool Contains(std::string_view key) const;
 
             //
             // Add a new element to the set.
             //
 
-            void Add(const std::string &item);
+            void Add(std::string_view item);
 
             //
             // Add a sequence of items to the set.
             //
 
-            void AddItems(const std::string &items);
+            void AddItems(std::string_view items);
 
             //
             // Remove an element from the set.  Return false if the item was not
             // in the set.
             //
 
-            bool Remove(const std::string &item);
+            bool Remove(std::string_view item);
 
             //
             // Return an iterator to a requested key or to the end of the set.
             //
 
-            ValueIterator<std::set<std::string>> * Find(const std::string & refKey);
+            SetIterator * Find(std::string_view refKey);
 
             //
-            // When a member function is called on the type, this method is called.
-            // It returns true if the method succeeded and false otherwise.
+            // Return the member table that names the members to MQ2.
             //
 
-            virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override;
+            static const MQTypeMember * GetMembers();
 
             //
-            // Convert the set to a string -- output the count of items.
+            // Return the member table entry for a member name or null if there
+            // is no such member.
             //
 
-            bool ToString(MQVarPtr VarPtr, PCHAR Destination);
+            static const MQTypeMember * LookupMember(const char * Name);
 
             //
-            // This method is executed when the /varset statement is executed.  Treat
-            // this as a set Add call.
+            // When a member function is called on the type, this method is called.
+            // It returns true if the method succeeded and false otherwise.
             //
 
-            virtual bool FromString(MQVarPtr& VarPtr, const char* Source) override;
+            static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest);
 
-        protected:
+            //
+            // Convert the set to a string -- output the count of items.
+            //
+
+            static bool ToString(MQVarPtr VarPtr, PCHAR Destination);
 
             //
-            // Return an iterator on the set.
+            // This method is executed when the /varset statement is executed.  Treat
+            // this as a set Add call.
             //
 
-            std::unique_ptr<ValueIterator<std::set<std::string>>> GetNewIterator(
-                        const std::set<std::string> & refCollection) const;
+            static bool AssignFromString(MQVarPtr& VarPtr, const char* Source);
 
         private:
 
@@ -264,7 +273,7 @@ namespace Collections
             // Iterator returned by Find operations.
             //
 
-            std::unique_ptr<SetIterator> m_findIter;
+            IteratorSlot<SetIterator> m_findIter;
 
             //
             // Map from member ids onto names.
@@ -3,7 +3,10 @@
 //
 
 
+#include <iterator>
+
 #include "Stack.h"
+#include "MemberDispatch.h"
 #include "Conversions.h"
 
 using namespace Collections::Containers;
@@ -13,7 +16,7 @@ using namespace Collections::Containers;
 // pointer.
 //
 
-const MQTypeMember Stack::StackMembers[] =
+constexpr MQTypeMember Stack::StackMembers[] =
 {
     { (DWORD) StackMembers::Count, "Count" },
     { (DWORD) StackMembers::Push, "Push" },
@@ -23,16 +26,37 @@ const MQTypeMember Stack::StackMembers[] =
     { 0, 0 }
 };
 
+//
+// Return the member table that names the members to MQ2.
+//
+
+const MQTypeMember * Stack::GetMembers()
+{
+    return StackMembers;
+}
+
+//
+// Return the member table entry for a member name or null if there is no
+// such member.  The perfect hash is built at compile time.
+//
+
+const MQTypeMember * Stack::LookupMember(const char * Name)
+{
+    static constexpr Types::MemberDispatch<std::size(StackMembers)> dispatch(StackMembers);
+
+    return dispatch.Find(Name);
+}
+
 //
 // When a member function is called on the type, this method is called.
 // It returns true if the method succeeded and false otherwise.
 //
 
-bool Stack::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+bool Stack::InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
 {
     Stack *pThis;
     std::string value;
-    std::unique_ptr<std::string> pValue;
+    const std::string * pValue;
 
     //
     // Default return value is FALSE.
@@ -45,7 +69,7 @@ bool Stack::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVa
     // Map the member name to the id.
     //
 
-	auto pMember = Stack::FindMember(Member);
+	auto pMember = LookupMember(Member);
     if (pMember == nullptr)
     {
         //
@@ -103,9 +127,9 @@ bool Stack::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVa
             // empty, return FALSE.
             //
 
-            if (pThis->Pop(&pValue))
+            if (pThis->Pop(&ResultSlot<Stack>::Value()))
             {
-                Dest.Ptr = (PVOID)pThis->m_Buffer.SetBuffer(pValue->c_str(), pValue->size() + 1);
+                Dest.Ptr = (PVOID) ResultSlot<Stack>::Pointer();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -127,7 +151,7 @@ bool Stack::GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVa
 
             if (pThis->Peek(&pValue))
             {
-                Dest.Ptr = (PVOID)pThis->m_Buffer.SetBuffer(pValue->c_str(), pValue->size() + 1);
+                Dest.Ptr = (PVOID) pValue->c_str();
                 Dest.Type = mq::datatypes::pStringType;
             }
             break;
@@ -166,7 +190,7 @@ bool Stack::ToString(MQVarPtr VarPtr, PCHAR Destination)
 // this as a stack Push call.
 //
 
-bool Stack::FromString(MQVarPtr& VarPtr, const char* Source)
+bool Stack::AssignFromString(MQVarPtr& VarPtr, const char* Source)
 {
     Stack *pDest;
 
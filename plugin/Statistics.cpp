@@ -0,0 +1,294 @@
+//
+// Gather call counts, latency distributions and element high-water marks
+// for the collection types.
+//
+
+#include <array>
+#include <cctype>
+#include <map>
+#include <utility>
+
+#include "Diagnostics.h"
+#include "Statistics.h"
+
+using namespace Diagnostics;
+
+namespace
+{
+    //
+    // Latencies are kept in a log-linear histogram: each power of two is
+    // split into 2^SubBucketBits buckets, so a percentile is accurate to
+    // within 1/8th of its value.
+    //
+
+    const unsigned SubBucketBits = 3;
+    const size_t SubBuckets = 1 << SubBucketBits;
+    const size_t BucketCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+    //
+    // Counts for one type and member.
+    //
+
+    struct MemberEntry
+    {
+        uint64_t Calls = 0;
+        uint64_t TotalNanoseconds = 0;
+        uint64_t MaxNanoseconds = 0;
+        std::array<uint64_t, BucketCount> Histogram {};
+    };
+
+    //
+    // Entries are keyed on the addresses of the type and member names.
+    //
+
+    std::map<std::pair<const char *, const char *>, MemberEntry> & MemberEntries()
+    {
+        static std::map<std::pair<const char *, const char *>, MemberEntry> entries;
+
+        return entries;
+    }
+
+    std::map<const char *, uint64_t> & Marks()
+    {
+        static std::map<const char *, uint64_t> marks;
+
+        return marks;
+    }
+
+    //
+    // Return the index of the highest set bit of a non-zero value.
+    //
+
+    unsigned FloorLog2(uint64_t value)
+    {
+        unsigned result = 0;
+
+        for (unsigned shift = 32; shift != 0; shift /= 2)
+        {
+            if (value >= ((uint64_t) 1 << shift))
+            {
+                value >>= shift;
+                result += shift;
+            }
+        }
+
+        return result;
+    }
+
+    //
+    // Return the histogram bucket for a latency.
+    //
+
+    size_t BucketIndex(uint64_t nanoseconds)
+    {
+        if (nanoseconds < SubBuckets)
+        {
+            return (size_t) nanoseconds;
+        }
+
+        unsigned exponent = FloorLog2(nanoseconds);
+
+        return (exponent - SubBucketBits + 1) * SubBuckets
+             + (size_t) ((nanoseconds >> (exponent - SubBucketBits)) & (SubBuckets - 1));
+    }
+
+    //
+    // Return the latency in the middle of a histogram bucket.
+    //
+
+    uint64_t BucketValue(size_t index)
+    {
+        if (index < SubBuckets)
+        {
+            return index;
+        }
+
+        unsigned exponent = (unsigned) (index / SubBuckets) + SubBucketBits - 1;
+        uint64_t width = (uint64_t) 1 << (exponent - SubBucketBits);
+        uint64_t lower = (SubBuckets + index % SubBuckets) * width;
+
+        return lower + width / 2;
+    }
+
+    //
+    // Return the latency below which a fraction of the calls fall.
+    //
+
+    uint64_t Percentile(const MemberEntry & entry, double fraction)
+    {
+        uint64_t target = (uint64_t) (fraction * entry.Calls);
+        uint64_t seen = 0;
+
+        for (size_t i = 0; i < BucketCount; ++i)
+        {
+            seen += entry.Histogram[i];
+            if (seen > target)
+            {
+                return BucketValue(i) < entry.MaxNanoseconds ? BucketValue(i) : entry.MaxNanoseconds;
+            }
+        }
+
+        return 0;
+    }
+
+    //
+    // Compare two names without regard to case, as MQ2 does.
+    //
+
+    bool SameName(const char * a, const char * b)
+    {
+        while (*a && (std::tolower((unsigned char) *a) == std::tolower((unsigned char) *b)))
+        {
+            ++a;
+            ++b;
+        }
+
+        return std::tolower((unsigned char) *a) == std::tolower((unsigned char) *b);
+    }
+
+    Statistics::MemberStatistics Summarize(const std::pair<const char *, const char *> & key,
+                                           const MemberEntry & entry)
+    {
+        return Statistics::MemberStatistics
+        {
+            key.first,
+            key.second,
+            entry.Calls,
+            entry.TotalNanoseconds,
+            Percentile(entry, 0.50),
+            Percentile(entry, 0.99),
+            entry.MaxNanoseconds
+        };
+    }
+}
+
+//
+// Start or stop gathering statistics.
+//
+
+void Statistics::Enable(bool enable)
+{
+    Instrumentation::Enable(Instrumentation::Statistics, enable);
+}
+
+//
+// Return true if statistics are being gathered.
+//
+
+bool Statistics::Enabled()
+{
+    return Instrumentation::Enabled(Instrumentation::Statistics);
+}
+
+//
+// Count a member call and its latency.
+//
+
+void Statistics::RecordCall(const char * type, const char * member, uint64_t nanoseconds)
+{
+    MemberEntry & entry = MemberEntries()[std::make_pair(type, member)];
+
+    entry.Calls += 1;
+    entry.TotalNanoseconds += nanoseconds;
+    entry.Histogram[BucketIndex(nanoseconds)] += 1;
+
+    if (nanoseconds > entry.MaxNanoseconds)
+    {
+        entry.MaxNanoseconds = nanoseconds;
+    }
+}
+
+//
+// Note the number of elements in a collection of a type after a member
+// call.
+//
+
+void Statistics::RecordElements(const char * type, size_t elements)
+{
+    uint64_t & mark = Marks()[type];
+
+    if (elements > mark)
+    {
+        mark = elements;
+    }
+}
+
+//
+// Return the statistics for each member called since statistics were
+// enabled or last reset.
+//
+
+std::vector<Statistics::MemberStatistics> Statistics::Members()
+{
+    std::vector<MemberStatistics> result;
+
+    for (const auto & entry : MemberEntries())
+    {
+        result.push_back(Summarize(entry.first, entry.second));
+    }
+
+    return result;
+}
+
+//
+// Return the high-water marks for each collection type.
+//
+
+std::vector<Statistics::TypeStatistics> Statistics::HighWaterMarks()
+{
+    std::vector<TypeStatistics> result;
+
+    for (const auto & entry : Marks())
+    {
+        result.push_back(TypeStatistics { entry.first, entry.second });
+    }
+
+    return result;
+}
+
+//
+// Find the statistics for a type and member by name.  Return false if the
+// member hasn't been called.
+//
+
+bool Statistics::Find(const char * type, const char * member, MemberStatistics & result)
+{
+    for (const auto & entry : MemberEntries())
+    {
+        if (SameName(entry.first.first, type) && SameName(entry.first.second, member))
+        {
+            result = Summarize(entry.first, entry.second);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//
+// Return the high-water mark for a type by name, or 0 if it hasn't been
+// seen.
+//
+
+uint64_t Statistics::HighWaterMark(const char * type)
+{
+    for (const auto & entry : Marks())
+    {
+        if (SameName(entry.first, type))
+        {
+            return entry.second;
+        }
+    }
+
+    return 0;
+}
+
+//
+// Discard the statistics gathered so far.
+//
+
+void Statistics::Reset()
+{
+    MemberEntries().clear();
+    Marks().clear();
+}
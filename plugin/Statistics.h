@@ -0,0 +1,105 @@
+//
+// Statistics.h
+//
+// Gather call counts, latency distributions and element high-water marks
+// for the collection types while statistics are enabled.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Diagnostics
+{
+    class Statistics
+    {
+    public:
+
+        //
+        // Calls made to one member of a type.  Type and Member point at the
+        // names in the type's member table.
+        //
+
+        struct MemberStatistics
+        {
+            const char * Type;
+            const char * Member;
+            uint64_t Calls;
+            uint64_t TotalNanoseconds;
+            uint64_t P50Nanoseconds;
+            uint64_t P99Nanoseconds;
+            uint64_t MaxNanoseconds;
+        };
+
+        //
+        // Largest collection of a type seen by a member call.
+        //
+
+        struct TypeStatistics
+        {
+            const char * Type;
+            uint64_t HighWaterMark;
+        };
+
+        //
+        // Start or stop gathering statistics.
+        //
+
+        static void Enable(bool enable);
+
+        //
+        // Return true if statistics are being gathered.
+        //
+
+        static bool Enabled();
+
+        //
+        // Count a member call and its latency.
+        //
+
+        static void RecordCall(const char * type, const char * member, uint64_t nanoseconds);
+
+        //
+        // Note the number of elements in a collection of a type after a
+        // member call.
+        //
+
+        static void RecordElements(const char * type, size_t elements);
+
+        //
+        // Return the statistics for each member called since statistics
+        // were enabled or last reset.
+        //
+
+        static std::vector<MemberStatistics> Members();
+
+        //
+        // Return the high-water marks for each collection type.
+        //
+
+        static std::vector<TypeStatistics> HighWaterMarks();
+
+        //
+        // Find the statistics for a type and member by name.  Return false if
+        // the member hasn't been called.
+        //
+
+        static bool Find(const char * type, const char * member, MemberStatistics & result);
+
+        //
+        // Return the high-water mark for a type by name, or 0 if it hasn't
+        // been seen.
+        //
+
+        static uint64_t HighWaterMark(const char * type);
+
+        //
+        // Discard the statistics gathered so far.
+        //
+
+        static void Reset();
+    };
+}
@@ -4,11 +4,14 @@
 
 #pragma once
 #include "DebugMemory.h"
+#include "DelimiterScanner.h"
 
-#include <tchar.h>
-
+#include <charconv>
+#include <cstring>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 #include <memory>
 
@@ -16,6 +19,283 @@ namespace Extensions
 {
     namespace Strings
     {
+        //
+        // Characters Trim removes by default.
+        //
+
+        constexpr char WhiteSpace[] = " \t\n\r\f";
+
+        //
+        // Return text without any of stripChars at either end.  The result
+        // is a view of text; nothing is copied.
+        //
+
+        inline std::string_view TrimView(std::string_view text, std::string_view stripChars = WhiteSpace)
+        {
+            auto first = text.find_first_not_of(stripChars);
+            if (first == std::string_view::npos)
+            {
+                return text.substr(text.size());
+            }
+
+            return text.substr(first, text.find_last_not_of(stripChars) - first + 1);
+        }
+
+        namespace Details
+        {
+            //
+            // Add the characters from first until a terminating double quote or
+            // the end of the string to the item.  Embedded quoted characters
+            // preceded by a \ character are copied to the output.  Return the
+            // position after the terminating quote.
+            //
+
+            inline const char * SpanUntilQuote(const DelimiterScanner & quoted,
+                                               const char * first,
+                                               const char * last,
+                                               std::string * item)
+            {
+                for (;;)
+                {
+                    const char * next = quoted.Find(first, last);
+
+                    item->append(first, next);
+
+                    if (next == last)
+                    {
+                        //
+                        // End of the string. We're done.
+                        //
+
+                        return last;
+                    }
+
+                    if (*next == '\"')
+                    {
+                        //
+                        // Matched the quote. We're done.
+                        //
+
+                        return next + 1;
+                    }
+
+                    //
+                    // Next character is quoted. Append it to the output unless
+                    // the backslash ends the string.
+                    //
+
+                    if (next + 1 == last)
+                    {
+                        return last;
+                    }
+
+                    item->push_back(next[1]);
+                    first = next + 2;
+                }
+            }
+        }  // namespace Details
+
+        //
+        // Split text into items delimited by any of a set of separators and
+        // call sink(item, unquoted) for each one in order.
+        //
+        // A backslash copies the next character literally and a double quote
+        // copies everything up to the matching quote without treating
+        // separators as such.  An item with neither is a view of text.  An
+        // item that had quotes or escapes removed is built at the end of
+        // unquoted and unquoted is true; the sink may clear unquoted or leave
+        // the item there, and the next one is built after it.  If there are
+        // no separators, text is the only item.
+        //
+
+        template <typename Sink>
+        void SplitText(std::string_view text, std::string_view separators, std::string & unquoted, Sink && sink)
+        {
+            if (separators.empty())
+            {
+                sink(text, false);
+                return;
+            }
+
+            //
+            // The scanner skips the runs of characters that are neither
+            // separators, quotes nor backslashes and they are copied whole.
+            //
+
+            DelimiterScanner delimiters(separators.data(), separators.size());
+            DelimiterScanner special(separators.data(), separators.size());
+            DelimiterScanner quoted("\\\"", 2);
+
+            special.Add("\\\"", 2);
+
+            const char * position = text.data();
+            const char * end = position + text.size();
+            size_t start = unquoted.size();
+
+            for (;;)
+            {
+                const char * next = special.Find(position, end);
+
+                //
+                // A backslash quotes the next character even if it is also a
+                // separator.
+                //
+
+                if ((next == end) || ((*next != '\\') && delimiters.Contains(*next)))
+                {
+                    //
+                    // The item is complete. Hand it to the sink.
+                    //
+
+                    if (unquoted.size() == start)
+                    {
+                        sink(std::string_view(position, next - position), false);
+                    }
+                    else
+                    {
+                        unquoted.append(position, next);
+                        sink(std::string_view(unquoted.data() + start, unquoted.size() - start), true);
+                    }
+
+                    if (next == end)
+                    {
+                        break;
+                    }
+
+                    start = unquoted.size();
+                    position = next + 1;
+                    continue;
+                }
+
+                unquoted.append(position, next);
+
+                if (*next == '\\')
+                {
+                    //
+                    // Add the quoted character unless the backslash ends the
+                    // string.
+                    //
+
+                    if (next + 1 == end)
+                    {
+                        position = end;
+                    }
+                    else
+                    {
+                        unquoted.push_back(next[1]);
+                        position = next + 2;
+                    }
+                }
+                else
+                {
+                    //
+                    // Add all characters to the item until either the end of
+                    // the string or a matching quote is found.
+                    //
+
+                    position = Details::SpanUntilQuote(quoted, next + 1, end, &unquoted);
+                }
+            }
+        }
+
+        //
+        // The items of a split argument as views, without a string for each
+        // item.  Only the items that had quotes or escapes removed are
+        // copied, into storage the object keeps and reuses, so splitting
+        // with the same object again allocates nothing once it has grown.
+        //
+        // The views are valid until the next Split and only while the text
+        // that was split is unchanged.
+        //
+
+        class SplitItems
+        {
+        public:
+
+            typedef std::vector<std::string_view>::const_iterator const_iterator;
+
+            //
+            // Split text on any of separators as StringExtensions::Split
+            // does, trimming white space from each item if trim is true.
+            //
+
+            void Split(std::string_view text, std::string_view separators, bool trim = false)
+            {
+                m_items.clear();
+                m_unquotedItems.clear();
+                m_unquoted.clear();
+
+                SplitText(text,
+                          separators,
+                          m_unquoted,
+                          [this, trim] (std::string_view item, bool fromUnquoted)
+                          {
+                              if (trim)
+                              {
+                                  item = TrimView(item);
+                              }
+
+                              //
+                              // Items in the storage are found again by offset
+                              // once it has stopped growing.
+                              //
+
+                              if (fromUnquoted)
+                              {
+                                  m_unquotedItems.push_back(UnquotedItem { m_items.size(), (size_t) (item.data() - m_unquoted.data()) });
+                              }
+
+                              m_items.push_back(item);
+                          });
+
+                for (const auto & unquotedItem : m_unquotedItems)
+                {
+                    m_items[unquotedItem.Index] = std::string_view(m_unquoted.data() + unquotedItem.Offset, m_items[unquotedItem.Index].size());
+                }
+            }
+
+            size_t size() const
+            {
+                return m_items.size();
+            }
+
+            bool empty() const
+            {
+                return m_items.empty();
+            }
+
+            const std::string_view & operator[](size_t index) const
+            {
+                return m_items[index];
+            }
+
+            const_iterator begin() const
+            {
+                return m_items.cbegin();
+            }
+
+            const_iterator end() const
+            {
+                return m_items.cend();
+            }
+
+        private:
+
+            //
+            // An item kept in m_unquoted, by its index and offset.
+            //
+
+            struct UnquotedItem
+            {
+                size_t Index;
+                size_t Offset;
+            };
+
+            std::vector<std::string_view> m_items;
+            std::vector<UnquotedItem> m_unquotedItems;
+            std::string m_unquoted;
+        };
+
         //
         // Extend the standard string class by providing useful methods on
         // a string and collections of strings.
@@ -61,95 +341,28 @@ namespace Extensions
             //
             // Split a string into a collection of substrings delimited by
             // any of a set of delimiters.  Return the collection of the items
-            // to the caller.
+            // to the caller.  SplitText describes the quoting rules.
             //
 
             std::unique_ptr<Container> Split(const T & separators) const
             {
-                auto results = std::make_unique<Container>();
-
-                //
-                // If the separators are null, return the contents as a single element.
-                //
-
-                if (separators.length() == 0)
-                {
-                    results->push_back(m_contents);
-                }
-                else
-                {
-                    //
-                    // Span the input string. If the character is a quotation character
-                    // (either " or ') then skip forward until we find the terminating
-                    // quote. Note: if characters are quoted with a \, then simply
-                    // copy out the next character without regard to it being a quote.
-                    // For each span separated by a separator, add it to the output
-                    // containter.
-                    //
-
-                    T item;
-                    auto it = m_contents.cbegin();
-                    for (;;)
-                    {
-                        if (it == m_contents.cend())
-                        {
-                            break;
-                        }
-
-                        //
-                        // Is the current character a quoted character (preceded by a '\'')?
-                        // Yes, add the quoted character.
-                        //
+                static_assert(std::is_same<typename T::value_type, char>::value, "Split scans bytes; T must be a string of char.");
 
-                        if (*it == '\\')
-                        {
-                            if (++it != m_contents.cend())
-                            {
-                                item.push_back(*it);
-                            }
-                        }
-                        else if (separators.find_first_of(*it) != T::npos)
-                        {
-                            //
-                            // Yes. the input string is complete. Add it to the output.
-                            //
-
-                            item.shrink_to_fit();
-                            results->push_back(item);;
-
-                            item.clear();
-                        }
-                        else if (*it == '\"')
-                        {
-                            //
-                            // Add all characters to the item until either the end
-                            // of the string or a matching quote is found.
-                            //
-
-                            SpanUntilQuote(*it, &it, &item);
-                        }
-                        else
-                        {
-                            //
-                            // Add the character to the current item.
-                            //
-
-                            item.push_back(*it);
-                        }
+                auto results = std::make_unique<Container>();
+                T unquoted;
 
-                        //
-                        // Bump to the next character unless we are at the end.
-                        //
-                        
-                        if (it != m_contents.cend())
-                        {
-                            ++it;
-                        }
-                    }
+                SplitText(m_contents,
+                          separators,
+                          unquoted,
+                          [&results, &unquoted] (std::string_view item, bool fromUnquoted)
+                          {
+                              results->push_back(T(item));
 
-                    item.shrink_to_fit();
-                    results->push_back(item);
-                }
+                              if (fromUnquoted)
+                              {
+                                  unquoted.clear();
+                              }
+                          });
 
                 return results;
             }
@@ -215,7 +428,7 @@ namespace Extensions
             template<class ContainerType = Container>
             std::unique_ptr<StringExtensionsT<T, ContainerType>> TrimStart() const
             {
-                return TrimStart<ContainerType>(T(" \t\n\r\f"));
+                return TrimStart<ContainerType>(T(WhiteSpace));
             }
 
             //
@@ -257,7 +470,7 @@ namespace Extensions
             template<class ContainerType = Container>
             std::unique_ptr<StringExtensionsT<T, ContainerType>> TrimEnd() const
             {
-                return TrimEnd<ContainerType>(T(" \t\n\r\f"));
+                return TrimEnd<ContainerType>(T(WhiteSpace));
             }
 
             //
@@ -297,7 +510,7 @@ namespace Extensions
             template<class ContainerType = Container>
             std::unique_ptr<StringExtensionsT<T, ContainerType>> Trim() const
             {
-                return Trim<ContainerType>(T(" \t\n\r\f"));
+                return Trim<ContainerType>(T(WhiteSpace));
             }
 
             //
@@ -331,7 +544,7 @@ namespace Extensions
 
             void RemoveEmptyStrings(Container & container) const
             {
-                Container::iterator it;
+                typename Container::iterator it;
                 static T emptyString;
                 Container newContainer;
 
@@ -358,60 +571,6 @@ namespace Extensions
                 }
             }
             
-            //
-            // Add characters under the input iterator until a terminating quote matching
-            // 'quote' is found or the end of the string is found. Embedded quoted characters
-            // preceded by a \ character are copied to the output.
-            //
-
-            void SpanUntilQuote(typename T::value_type quote,
-                                typename T::const_iterator * it,
-                                T * item) const
-            {
-                //
-                // Skip the starting quote and span the remaining characters.
-                //
-
-                ++(*it);
-                while (true)
-                {
-                    if (*it == m_contents.cend())
-                    {
-                        //
-                        // End of the string. We're done.
-                        //
-
-                        return;
-                    }
-
-                    if (**it == quote)
-                    {
-                        //
-                        // Matched the quote. We're done.
-                        //
-
-                        return;
-                    }
-
-                    if (**it == '\\')
-                    {
-                        //
-                        // Next character is quoted. Append it to the output unless
-                        // the next character is the end of the string.
-                        //
-
-                        if (++(*it) == m_contents.cend())
-                        {
-                            return;
-                        }
-                    }
-
-                    item->push_back(**it);
-
-                    ++(*it);
-                }
-            }
-
             //
             // String manipulated by this class.
             //
@@ -427,60 +586,96 @@ namespace Extensions
         using StringExtensions = StringExtensionsT<std::string>;
 
         //
-        // Convert a std::string to a specified integral type.  Return true if
-        // the string was successfully converted and false otherwise.
+        // Convert the characters in [first, last) to a specified integral
+        // type.  Leading and trailing white space is ignored and the number
+        // may have a sign; a minus sign fails for an unsigned type.  Return
+        // true if the whole range is a number that fits in U and false
+        // otherwise, leaving *result unchanged.
+        //
+        // Nothing is allocated and no exception is thrown, so this is safe
+        // to call on a member's raw Index inside a macro loop.
         //
 
-        template <class T, typename U>
-        bool FromString(const T & value, U * result)
+        template <typename U>
+        bool ParseInteger(const char * first, const char * last, U * result)
         {
-            T::size_type sz;
-            U convertedvalue;
+            static_assert(std::is_integral<U>::value, "ParseInteger requires an integral type.");
 
             //
-            // Fail if there is no output pointer.
+            // Fail if there is no output pointer or no input.
             //
 
-            if (!result)
+            if (!result || !first || (first > last))
             {
                 return false;
             }
 
+            auto isSpace = [](char c)
+            {
+                return (c == ' ') || (c == '\t') || (c == '\n') || (c == '\r') || (c == '\f');
+            };
+
+            while ((first != last) && isSpace(*first))
+            {
+                ++first;
+            }
+
+            while ((last != first) && isSpace(*(last - 1)))
+            {
+                --last;
+            }
+
             //
-            // Trim any characters from the string before converting it.
+            // from_chars doesn't accept a plus sign.
             //
 
-            std::unique_ptr<StringExtensionsT<T>> se = std::make_unique<StringExtensionsT<T>>(value);
-            auto trimmed(se->Trim());
-
-            try
+            if ((first != last) && (*first == '+'))
             {
-                convertedvalue = (U) std::stoll(trimmed->Contents(), &sz);
-                if (trimmed->Contents()[sz] != 0)
-                {
-                    //
-                    // Expect terminating character to be a null.
-                    //
+                ++first;
 
+                if ((first == last) || (*first == '-'))
+                {
                     return false;
                 }
+            }
 
-                //
-                // Set the output value.
-                //
+            U value;
+            auto converted = std::from_chars(first, last, value);
 
-                *result = convertedvalue;
-            }
-            catch (std::invalid_argument &)
+            if ((converted.ec != std::errc()) || (converted.ptr != last))
             {
                 return false;
             }
-            catch (std::out_of_range &)
+
+            *result = value;
+
+            return true;
+        }
+
+        //
+        // Convert a null terminated string to a specified integral type.
+        //
+
+        template <typename U>
+        bool ParseInteger(const char * text, U * result)
+        {
+            if (!text)
             {
                 return false;
             }
 
-            return true;
+            return ParseInteger(text, text + std::strlen(text), result);
+        }
+
+        //
+        // Convert a std::string to a specified integral type.  Return true if
+        // the string was successfully converted and false otherwise.
+        //
+
+        template <class T, typename U>
+        bool FromString(const T & value, U * result)
+        {
+            return ParseInteger(value.data(), value.data() + value.size(), result);
         }
     }
 }
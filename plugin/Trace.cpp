@@ -0,0 +1,322 @@
+//
+// Record member calls on the collection types to a binary trace.
+//
+
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include "Diagnostics.h"
+#include "Trace.h"
+#include "TraceFormat.h"
+#include "Types.h"
+
+using namespace Diagnostics;
+using namespace Diagnostics::TraceFormat;
+
+namespace
+{
+    //
+    // Flush the record buffer to the file once it grows past this size.
+    //
+
+    const size_t FlushThreshold = 64 * 1024;
+
+    //
+    // Records not yet written to the file.
+    //
+
+    std::string buffer;
+
+    //
+    // Ids of the type and member names defined so far.
+    //
+
+    std::unordered_map<std::string, uint64_t> symbols;
+
+    //
+    // Ids of the live objects seen so far.
+    //
+
+    std::unordered_map<const void *, uint64_t> objects;
+    uint64_t nextObject;
+
+    //
+    // Return the id of a name, writing a Symbol record the first time the
+    // name is seen.
+    //
+
+    uint64_t SymbolId(const char * name)
+    {
+        auto it = symbols.find(name);
+        if (it != symbols.end())
+        {
+            return it->second;
+        }
+
+        uint64_t id = symbols.size() + 1;
+
+        symbols.emplace(name, id);
+
+        buffer.push_back((char) RecordKind::Symbol);
+        PutVarint(buffer, id);
+        PutString(buffer, name, std::strlen(name));
+
+        return id;
+    }
+
+    //
+    // Return the id of an object, assigning a new one the first time the
+    // object is seen.
+    //
+
+    uint64_t ObjectId(const void * object)
+    {
+        if (object == nullptr)
+        {
+            return 0;
+        }
+
+        auto result = objects.emplace(object, nextObject);
+        if (result.second)
+        {
+            ++nextObject;
+        }
+
+        return result.first->second;
+    }
+
+    //
+    // Write the buffered records once enough have accumulated.
+    //
+
+    void Flush(std::FILE * file, bool force)
+    {
+        if ((force || (buffer.size() >= FlushThreshold)) && !buffer.empty())
+        {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+    }
+}
+
+std::FILE * TraceRecorder::traceFile = nullptr;
+uint64_t TraceRecorder::recordCount = 0;
+
+//
+// Start recording to a file, replacing any previous contents.  Return false
+// if a trace is already being recorded or the file can't be created.
+//
+
+bool TraceRecorder::Start(const char * path)
+{
+    if (traceFile != nullptr)
+    {
+        return false;
+    }
+
+    std::FILE * file = std::fopen(path, "wb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+
+    uint8_t version[4] =
+    {
+        (uint8_t) Version,
+        (uint8_t) (Version >> 8),
+        (uint8_t) (Version >> 16),
+        (uint8_t) (Version >> 24)
+    };
+
+    std::fwrite(Magic, 1, sizeof(Magic), file);
+    std::fwrite(version, 1, sizeof(version), file);
+
+    buffer.clear();
+    buffer.reserve(FlushThreshold * 2);
+    symbols.clear();
+    objects.clear();
+    nextObject = 1;
+    recordCount = 0;
+
+    traceFile = file;
+    Instrumentation::Enable(Instrumentation::Trace, true);
+
+    return true;
+}
+
+//
+// Stop recording and close the trace file.  Return the number of records
+// written.
+//
+
+uint64_t TraceRecorder::Stop()
+{
+    if (traceFile == nullptr)
+    {
+        return 0;
+    }
+
+    Instrumentation::Enable(Instrumentation::Trace, false);
+
+    Flush(traceFile, true);
+    std::fclose(traceFile);
+    traceFile = nullptr;
+
+    symbols.clear();
+    objects.clear();
+
+    return recordCount;
+}
+
+//
+// Record the creation of a variable.
+//
+
+void TraceRecorder::InitVariable(const char * typeName, const void * object)
+{
+    uint64_t type = SymbolId(typeName);
+
+    //
+    // A new variable can reuse the address of one that was freed; give it a
+    // new id.
+    //
+
+    objects.erase(object);
+
+    buffer.push_back((char) RecordKind::InitVariable);
+    PutVarint(buffer, type);
+    PutVarint(buffer, ObjectId(object));
+
+    ++recordCount;
+    Flush(traceFile, false);
+}
+
+//
+// Record the destruction of a variable.
+//
+
+void TraceRecorder::FreeVariable(const char * typeName, const void * object)
+{
+    uint64_t type = SymbolId(typeName);
+
+    buffer.push_back((char) RecordKind::FreeVariable);
+    PutVarint(buffer, type);
+    PutVarint(buffer, ObjectId(object));
+
+    objects.erase(object);
+
+    ++recordCount;
+    Flush(traceFile, false);
+}
+
+//
+// Record a member call and its result.
+//
+
+void TraceRecorder::GetMember(const char * typeName,
+                              const void * object,
+                              const char * member,
+                              const char * index,
+                              bool succeeded,
+                              const MQTypeVar & dest,
+                              uint64_t elapsedNanoseconds)
+{
+    uint64_t type = SymbolId(typeName);
+    uint64_t memberId = SymbolId(member);
+    uint64_t resultType = 0;
+    ResultKind resultKind = ResultKind::None;
+
+    //
+    // Classify the result before writing the record so any new symbol is
+    // defined ahead of it.
+    //
+
+    if (dest.Type != nullptr)
+    {
+        resultType = SymbolId(dest.Type->GetName());
+
+        if ((dest.Type == mq::datatypes::pStringType) && (dest.Ptr != nullptr))
+        {
+            resultKind = ResultKind::String;
+        }
+        else if (Types::TypeMap::HasName(dest.Type->GetName()))
+        {
+            resultKind = ResultKind::Object;
+
+            //
+            // Members that return a new object (Find, Clone, Splice, ...)
+            // hand back a fresh variable.
+            //
+
+            objects.erase(dest.Ptr);
+        }
+        else
+        {
+            resultKind = ResultKind::Integer;
+        }
+    }
+
+    uint8_t flags = (index != nullptr ? HasIndex : 0) | (succeeded ? Succeeded : 0);
+
+    buffer.push_back((char) RecordKind::GetMember);
+    PutVarint(buffer, type);
+    PutVarint(buffer, ObjectId(object));
+    PutVarint(buffer, memberId);
+    buffer.push_back((char) flags);
+
+    if (index != nullptr)
+    {
+        PutString(buffer, index, std::strlen(index));
+    }
+
+    PutVarint(buffer, elapsedNanoseconds);
+    buffer.push_back((char) resultKind);
+
+    switch (resultKind)
+    {
+        case ResultKind::Object:
+            PutVarint(buffer, resultType);
+            PutVarint(buffer, ObjectId(dest.Ptr));
+            break;
+
+        case ResultKind::String:
+            PutVarint(buffer, resultType);
+            PutString(buffer,
+                      reinterpret_cast<const char *>(dest.Ptr),
+                      std::strlen(reinterpret_cast<const char *>(dest.Ptr)));
+            break;
+
+        case ResultKind::Integer:
+            PutVarint(buffer, resultType);
+            PutSigned(buffer, dest.Int);
+            break;
+
+        default:
+            break;
+    }
+
+    ++recordCount;
+    Flush(traceFile, false);
+}
+
+//
+// Record a /varset on a variable.
+//
+
+void TraceRecorder::FromString(const char * typeName,
+                               const void * object,
+                               const char * source,
+                               bool succeeded)
+{
+    uint64_t type = SymbolId(typeName);
+
+    buffer.push_back((char) RecordKind::FromString);
+    PutVarint(buffer, type);
+    PutVarint(buffer, ObjectId(object));
+    buffer.push_back(succeeded ? 1 : 0);
+    PutString(buffer, source, source != nullptr ? std::strlen(source) : 0);
+
+    ++recordCount;
+    Flush(traceFile, false);
+}
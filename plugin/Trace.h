@@ -0,0 +1,103 @@
+//
+// Trace.h
+//
+// Record the member calls made on the collection types to a binary trace so
+// the same workload can be replayed offline.  See TraceFormat.h for the
+// layout of the trace.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstdint>
+#include <cstdio>
+
+#include "HostTypes.h"
+
+namespace Diagnostics
+{
+    class TraceRecorder
+    {
+    public:
+
+        //
+        // Start recording to a file, replacing any previous contents.
+        // Return false if a trace is already being recorded or the file
+        // can't be created.
+        //
+
+        static bool Start(const char * path);
+
+        //
+        // Stop recording and close the trace file.  Return the number of
+        // records written.
+        //
+
+        static uint64_t Stop();
+
+        //
+        // Return true if a trace is being recorded.
+        //
+
+        static bool Recording()
+        {
+            return traceFile != nullptr;
+        }
+
+        //
+        // Return the number of records written to the current trace.
+        //
+
+        static uint64_t Records()
+        {
+            return recordCount;
+        }
+
+        //
+        // Record the creation of a variable.
+        //
+
+        static void InitVariable(const char * typeName, const void * object);
+
+        //
+        // Record the destruction of a variable.
+        //
+
+        static void FreeVariable(const char * typeName, const void * object);
+
+        //
+        // Record a member call and its result.
+        //
+
+        static void GetMember(const char * typeName,
+                              const void * object,
+                              const char * member,
+                              const char * index,
+                              bool succeeded,
+                              const MQTypeVar & dest,
+                              uint64_t elapsedNanoseconds);
+
+        //
+        // Record a /varset on a variable.
+        //
+
+        static void FromString(const char * typeName,
+                               const void * object,
+                               const char * source,
+                               bool succeeded);
+
+    private:
+
+        //
+        // File being written or null when not recording.
+        //
+
+        static std::FILE * traceFile;
+
+        //
+        // Number of records written to the current trace.
+        //
+
+        static uint64_t recordCount;
+    };
+}
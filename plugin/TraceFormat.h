@@ -0,0 +1,161 @@
+//
+// TraceFormat.h
+//
+// Layout of the binary member call traces written by TraceRecorder and read
+// by the TraceReplay tool.
+//
+// A trace is the 8 byte Magic, a 32 bit little endian Version and then a
+// sequence of records.  Each record starts with a RecordKind byte.  Numbers
+// are unsigned LEB128 varints; signed numbers are zigzag encoded first.
+// Strings are a varint length followed by the bytes, without a terminator.
+//
+//  Symbol        id, string
+//                Defines a type or member name.  Later records refer to
+//                names by id.  Id 0 is never defined and means "none".
+//  InitVariable  type, object
+//  FreeVariable  type, object
+//  GetMember     type, object, member, flags, [index], elapsed ns,
+//                result kind byte, [result type, result]
+//                flags is a combination of MemberFlags.  The result type
+//                and value follow unless the kind is None: an object id for
+//                Object, a string for String and a zigzag Int for Integer.
+//  FromString    type, object, succeeded byte, source string
+//
+// Objects are identified by ids assigned in the order they are first seen
+// in the trace.  Object id 0 is a null variable.
+//
+
+#pragma once
+#include "DebugMemory.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+namespace Diagnostics
+{
+    namespace TraceFormat
+    {
+        constexpr char Magic[8] = { 'M', 'Q', '2', 'C', 'T', 'R', 'C', '\0' };
+        constexpr uint32_t Version = 1;
+
+        enum class RecordKind : uint8_t
+        {
+            Symbol = 1,
+            InitVariable,
+            FreeVariable,
+            GetMember,
+            FromString
+        };
+
+        enum MemberFlags : uint8_t
+        {
+            HasIndex = 0x01,
+            Succeeded = 0x02
+        };
+
+        //
+        // How the value returned in Dest is recorded.
+        //
+
+        enum class ResultKind : uint8_t
+        {
+            None,
+            Object,
+            String,
+            Integer
+        };
+
+        //
+        // Append an unsigned varint to a buffer.
+        //
+
+        inline void PutVarint(std::string & buffer, uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                buffer.push_back((char) ((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+
+            buffer.push_back((char) value);
+        }
+
+        //
+        // Append a signed value, zigzag encoded.
+        //
+
+        inline void PutSigned(std::string & buffer, int64_t value)
+        {
+            PutVarint(buffer, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+        }
+
+        //
+        // Append a length prefixed string.
+        //
+
+        inline void PutString(std::string & buffer, const char * value, size_t length)
+        {
+            PutVarint(buffer, length);
+            buffer.append(value, length);
+        }
+
+        //
+        // Read an unsigned varint.  Return false if the buffer ends first.
+        //
+
+        inline bool GetVarint(const uint8_t *& cursor, const uint8_t * end, uint64_t & value)
+        {
+            value = 0;
+
+            for (unsigned shift = 0; (cursor < end) && (shift < 64); shift += 7)
+            {
+                uint8_t byte = *cursor++;
+
+                value |= (uint64_t) (byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        //
+        // Read a zigzag encoded signed value.
+        //
+
+        inline bool GetSigned(const uint8_t *& cursor, const uint8_t * end, int64_t & value)
+        {
+            uint64_t encoded;
+
+            if (!GetVarint(cursor, end, encoded))
+            {
+                return false;
+            }
+
+            value = (int64_t) (encoded >> 1) ^ -(int64_t) (encoded & 1);
+            return true;
+        }
+
+        //
+        // Read a length prefixed string.
+        //
+
+        inline bool GetString(const uint8_t *& cursor, const uint8_t * end, std::string & value)
+        {
+            uint64_t length;
+
+            if (!GetVarint(cursor, end, length) || ((uint64_t) (end - cursor) < length))
+            {
+                return false;
+            }
+
+            value.assign(reinterpret_cast<const char *>(cursor), (size_t) length);
+            cursor += length;
+
+            return true;
+        }
+    }
+}
@@ -5,18 +5,28 @@
 #pragma once
 #include "DebugMemory.h"
 
+#include <atomic>
 #include <string>
 #include <map>
+#include <memory>
 #include <typeinfo>
+#include <type_traits>
+#include <utility>
 
-#include <mq/Plugin.h>
+#include "HostTypes.h"
+#include "Diagnostics.h"
+#include "Statistics.h"
+#include "Trace.h"
 
 #include "Macros.h"
+#include "ObjectPool.h"
 
 namespace Types
 {
     //
-    // Map from type names onto their ObjectTypes.
+    // Map from type names onto their TypeInterfaces.  The map owns the type
+    // instances and is used to register and tear them down; member calls
+    // find their type through BaseType's cached descriptor instead.
     //
 
     class TypeMap
@@ -59,57 +69,163 @@ namespace Types
     };
 
     //
-    // BaseType is an interface derived from MQ2Type which provides default
-    // functionality based on the MQ2Type interface.
+    // HasCount<T>::value is true if T has a Count() member -- that is, T is a
+    // collection rather than an iterator.
+    //
+
+    template <typename T, typename = void>
+    struct HasCount : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct HasCount<T, std::void_t<decltype(std::declval<const T &>().Count())>> : std::true_type
+    {
+    };
+
+    //
+    // TypeInterface is the MQ2Type registered for ObjectClass.  There is one
+    // per type: it holds the member names MQ2 knows the type by and forwards
+    // every call to ObjectClass's static members, which find the object
+    // through VarPtr.  Objects are plain C++ objects and carry none of it.
     //
 
     template <typename ObjectClass>
-    class BaseType : public MQ2Type
+    class TypeInterface : public MQ2Type
+    {
+    public:
+
+        TypeInterface()
+            : MQ2Type(const_cast<char *>(ObjectClass::GetTypeName()))
+        {
+            InitializeMembers(const_cast<MQTypeMember *>(ObjectClass::GetMembers()));
+        }
+
+        ~TypeInterface()
+        {
+        }
+
+        bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override
+        {
+            return ObjectClass::GetMember(VarPtr, Member, Index, Dest);
+        }
+
+        bool ToString(MQVarPtr VarPtr, PCHAR Destination) override
+        {
+            return ObjectClass::ToString(VarPtr, Destination);
+        }
+
+        void InitVariable(MQVarPtr& VarPtr) override
+        {
+            ObjectClass::InitVariable(VarPtr);
+        }
+
+        void FreeVariable(MQVarPtr& VarPtr) override
+        {
+            ObjectClass::FreeVariable(VarPtr);
+        }
+
+        bool FromData(MQVarPtr& VarPtr, const MQTypeVar& Source) override
+        {
+            return ObjectClass::FromData(VarPtr, Source);
+        }
+
+        bool FromString(MQVarPtr& VarPtr, const char* Source) override
+        {
+            return ObjectClass::FromString(VarPtr, Source);
+        }
+    };
+
+    //
+    // BaseType provides the default behavior of an object seen through its
+    // TypeInterface.  The members MQ2 calls are static and take the object
+    // from VarPtr; ObjectClass hides the ones it implements.
+    //
+
+    template <typename ObjectClass>
+    class BaseType
     {
     public:
 
         // Buffer pointed to by naked PCHAR is at least this long.
 
-        const int BUFFER_SIZE = MAX_STRING;
+        static const int BUFFER_SIZE = MAX_STRING;
+
+        BaseType()
+        {
+            Instances().fetch_add(1, std::memory_order_relaxed);
+        }
 
         //
-        // Initialize our methods and properties in MQ2.
+        // Objects are deleted through their ObjectClass pointer, so the
+        // destructor need not be virtual.
         //
 
-        BaseType(const MQTypeMember aMembers[])
-            : MQ2Type(const_cast<char *>(ObjectClass::GetTypeName()))
+        ~BaseType()
         {
-            InitializeMembers(const_cast<MQTypeMember*>(aMembers));
+            Instances().fetch_sub(1, std::memory_order_relaxed);
         }
 
         //
-        // Ensure derived class destructors are called when we are deleted.
+        // Return the number of ObjectClass instances alive.
         //
 
-        virtual ~BaseType()
+        static size_t LiveInstances()
         {
+            return Instances().load(std::memory_order_relaxed);
         }
 
         //
         // By default, this type can be deleted.
         //
 
-        virtual const bool CanDelete() const
+        bool CanDelete() const
         {
             return true;
         }
 
+        //
+        // A variable is given an object with /vardata.  By default, the
+        // variable takes the object as it is.
+        //
+
+        static void AdoptObject(ObjectClass *)
+        {
+        }
+
+        //
+        // A variable lets go of its object.  By default, the object is
+        // deleted if it can be deleted.
+        //
+
+        static void ReleaseObject(ObjectClass * object)
+        {
+            if (object->CanDelete())
+            {
+                delete object;
+            }
+        }
+
+        //
+        // By default, a variable of this type starts out without an object.
+        //
+
+        static void InitVariable(MQVarPtr& VarPtr)
+        {
+            VarPtr.Ptr = nullptr;
+        }
+
         //
         // This method is executed when the /vardata statement is executed on
         // the type.  Delete the destination instance and set the source
         // instance to it.
         //
 
-        bool FromData(MQVarPtr& VarPtr, const MQTypeVar& Source) override
+        static bool FromData(MQVarPtr& VarPtr, const MQTypeVar& Source)
         {
             ObjectClass * pDest;
 
-            if (Source.Type != TypeMap::GetTypeInstanceForTypeName(ObjectClass::GetTypeName()))
+            if (Source.Type != Descriptor())
             {
                 return false;
             }
@@ -117,53 +233,131 @@ namespace Types
             pDest = reinterpret_cast<ObjectClass *>(VarPtr.Ptr);
 
             //
-            // Delete the destination object if it is not the same as the
-            // source object and set the destination to the source.
+            // Let go of the destination object if it is not the same as the
+            // source object and give the variable the source.
             //
 
-            if (pDest != Source.Ptr)
+            if (pDest == Source.Ptr)
             {
-                if (CanDelete())
-                {
-                    delete pDest;
-                }
+                return true;
+            }
+
+            if (pDest != nullptr)
+            {
+                ObjectClass::ReleaseObject(pDest);
             }
 
             VarPtr.Ptr = Source.Ptr;
 
+            if (VarPtr.Ptr != nullptr)
+            {
+                ObjectClass::AdoptObject(reinterpret_cast<ObjectClass *>(VarPtr.Ptr));
+            }
+
             return true;
         }
 
         //
-        // Delete an instance of ObjectClass.
+        // Delete an instance of ObjectClass if the variable owns it.
         //
 
-        virtual void FreeVariable(MQVarPtr& VarPtr)
+        static void FreeVariable(MQVarPtr& VarPtr)
         {
-            if (CanDelete())
+            if (Diagnostics::TraceRecorder::Recording())
             {
-                delete reinterpret_cast<ObjectClass *>(VarPtr.Ptr);
+                Diagnostics::TraceRecorder::FreeVariable(ObjectClass::GetTypeName(), VarPtr.Ptr);
+            }
+
+            Diagnostics::OperationScope operation(ObjectClass::GetTypeName(), "FreeVariable");
+
+            auto pObject = reinterpret_cast<ObjectClass *>(VarPtr.Ptr);
+
+            if (pObject != nullptr)
+            {
+                ObjectClass::ReleaseObject(pObject);
             }
 
             VarPtr.Ptr = 0;
         }
 
         //
-        // The default implementation of GetMember returns false -- there
+        // Every member call on the type enters here.  Dispatch it to
+        // ObjectClass::InvokeMember, going through the instrumented path
+        // when a diagnostic feature is enabled.
+        //
+
+        static bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+        {
+            if (!Diagnostics::Instrumentation::Active())
+            {
+                return ObjectClass::InvokeMember(VarPtr, Member, Index, Dest);
+            }
+
+            return InstrumentedGetMember(VarPtr, Member, Index, Dest);
+        }
+
+        //
+        // The default implementation of InvokeMember returns false -- there
         // aren't any members on the type.
         //
 
-        virtual bool GetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest) override
+        static bool InvokeMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+        {
+            return false;
+        }
+
+        //
+        // By default, a type converts to its name.
+        //
+
+        static bool ToString(MQVarPtr VarPtr, PCHAR Destination)
+        {
+            return strcpy_s(Destination, BUFFER_SIZE, ObjectClass::GetTypeName()) == 0;
+        }
+
+        //
+        // This method is executed when the /varset statement is executed.
+        // Assign the value with ObjectClass::AssignFromString, applying the
+        // enabled diagnostics.
+        //
+
+        static bool FromString(MQVarPtr& VarPtr, const char* Source)
+        {
+            if (!Diagnostics::Instrumentation::Active())
+            {
+                return ObjectClass::AssignFromString(VarPtr, Source);
+            }
+
+            bool result;
+
+            {
+                Diagnostics::OperationScope operation(ObjectClass::GetTypeName(), "FromString", Source);
+
+                result = ObjectClass::AssignFromString(VarPtr, Source);
+            }
+
+            if (Diagnostics::TraceRecorder::Recording())
+            {
+                Diagnostics::TraceRecorder::FromString(ObjectClass::GetTypeName(), VarPtr.Ptr, Source, result);
+            }
+
+            return result;
+        }
+
+        //
+        // By default, a type can't be assigned from a string.
+        //
+
+        static bool AssignFromString(MQVarPtr& VarPtr, const char* Source)
         {
             return false;
         }
 
         //
-        // Register the type with MQ2, using an instance as our unique type
-        // descriptor.
+        // Register the type with MQ2, creating its one TypeInterface.
         //
 
-        static void RegisterType(ObjectClass * instance)
+        static void RegisterType()
         {
             //
             // If we were already registered, do nothing.
@@ -171,16 +365,16 @@ namespace Types
 
             if (!TypeMap::HasName(ObjectClass::GetTypeName()))
             {
-                //
-                // Associate the type with an instance -- this lets
-                // us compare the type information.
-                //
+                auto descriptor = new TypeInterface<ObjectClass>();
+
+                if (TypeMap::AddType(ObjectClass::GetTypeName(), descriptor))
+                {
+                    Descriptor() = descriptor;
+                }
 
-                TypeMap::AddType(ObjectClass::GetTypeName(), instance);
                 AddMQ2Data(const_cast<char *>(ObjectClass::GetTypeName()), TypeDescriptor);
             }
         }
-
         //
         // Unregister the type with MQ2.
         //
@@ -199,6 +393,7 @@ namespace Types
                 //
 
                 RemoveMQ2Data(const_cast<char *>(ObjectClass::GetTypeName()));
+                Descriptor() = nullptr;
                 TypeMap::RemoveType(ObjectClass::GetTypeName());
             }
         }
@@ -210,30 +405,126 @@ namespace Types
         static bool TypeDescriptor(const char* szName, MQTypeVar& Dest)
         {
             Dest.DWord = 1;
-            Dest.Type = TypeMap::GetTypeInstanceForTypeName(ObjectClass::GetTypeName());
+            Dest.Type = Descriptor();
 
             return TRUE;
         }
+
+    private:
+
+        //
+        // The TypeInterface registered for ObjectClass, or null while the
+        // type isn't registered.  TypeMap owns it; this copy lets
+        // TypeDescriptor and FromData find it without a map lookup.
+        //
+
+        static MQ2Type *& Descriptor()
+        {
+            static MQ2Type * descriptor = nullptr;
+
+            return descriptor;
+        }
+
+        static std::atomic<size_t> & Instances()
+        {
+            static std::atomic<size_t> instances(0);
+
+            return instances;
+        }
+
+        //
+        // Execute a member call with the enabled diagnostics: charge its
+        // allocations to the member, add it to the timeline, gather its
+        // statistics and record it in the trace.
+        //
+
+        static bool InstrumentedGetMember(MQVarPtr VarPtr, const char* Member, char* Index, MQTypeVar& Dest)
+        {
+            std::string index;
+            const char * memberName = "(unknown)";
+            bool recording = Diagnostics::TraceRecorder::Recording();
+            bool statistics = Diagnostics::Statistics::Enabled();
+            bool result;
+            uint64_t elapsed;
+
+            auto pMember = ObjectClass::LookupMember(Member);
+            if (pMember != nullptr)
+            {
+                memberName = pMember->Name;
+            }
+
+            if (recording && (Index != nullptr))
+            {
+                //
+                // Keep a copy of the index in case the member changes it.
+                //
+
+                index = Index;
+            }
+
+            {
+                Diagnostics::OperationScope operation(ObjectClass::GetTypeName(), memberName, Index);
+
+                result = ObjectClass::InvokeMember(VarPtr, Member, Index, Dest);
+                elapsed = operation.Elapsed();
+            }
+
+            if (statistics)
+            {
+                Diagnostics::Statistics::RecordCall(ObjectClass::GetTypeName(), memberName, elapsed);
+
+                RecordElements(VarPtr, HasCount<ObjectClass>());
+            }
+
+            if (recording)
+            {
+                Diagnostics::TraceRecorder::GetMember(
+                            ObjectClass::GetTypeName(),
+                            VarPtr.Ptr,
+                            Member,
+                            Index != nullptr ? index.c_str() : nullptr,
+                            result,
+                            Dest,
+                            elapsed);
+            }
+
+            return result;
+        }
+
+        //
+        // Note the size of a collection after a member call.  Iterators
+        // don't have a size.
+        //
+
+        static void RecordElements(MQVarPtr VarPtr, std::true_type)
+        {
+            if (VarPtr.Ptr != nullptr)
+            {
+                Diagnostics::Statistics::RecordElements(
+                            ObjectClass::GetTypeName(),
+                            reinterpret_cast<const ObjectClass *>(VarPtr.Ptr)->Count());
+            }
+        }
+
+        static void RecordElements(MQVarPtr VarPtr, std::false_type)
+        {
+        }
     };
 
     //
     // ReferenceType is a type with methods and properties.  It can not be
     // created by a /declare statement and is returned by a method on
-    // an ObjectType.  A ReferenceType takes an argument to its constructor
-    // which is a reference to an ObjectClass.
+    // an ObjectType.  Reference types are iterators: a variable shares
+    // them with the collection that returned them, and their storage is
+    // recycled through a pool.
     //
 
-    template <typename ObjectClass, typename Reference>
+    template <typename ObjectClass>
     class ReferenceType : public BaseType<ObjectClass>
     {
     public:
 
-        //
-        // Initialize our methods and properties in MQ2.
-        //
-
-        ReferenceType(const MQTypeMember aMembers[])
-            : BaseType<ObjectClass>(aMembers)
+        ReferenceType()
         {
         }
 
@@ -246,23 +537,34 @@ namespace Types
         }
 
         //
-        // This type cannot be deleted.
+        // Each variable given an iterator holds it along with the
+        // collection: the collection returning another one no longer
+        // deletes it.
         //
 
-        const bool CanDelete() const
+        static void AdoptObject(ObjectClass * object)
         {
-            return false;
+            object->TakeVariable();
         }
 
         //
-        // Register the type - reference types have an instance bound to a
-        // reference of Reference.
+        // The iterator is deleted once no variable and not the collection
+        // holds it.
         //
 
-        static void RegisterType()
+        static void ReleaseObject(ObjectClass * object)
+        {
+            object->ReleaseVariable();
+        }
+
+        static void * operator new(size_t size)
+        {
+            return Utilities::Pools::ObjectPool<ObjectClass>::Allocate(size);
+        }
+
+        static void operator delete(void * storage, size_t size)
         {
-            Reference *refClass = new Reference();
-            BaseType<ObjectClass>::RegisterType(new ObjectClass(*refClass));
+            Utilities::Pools::ObjectPool<ObjectClass>::Free(storage, size);
         }
     };
 
@@ -276,12 +578,7 @@ namespace Types
     {
     public:
 
-        //
-        // Initialize our methods and properties in MQ2.
-        //
-
-        ObjectType(const MQTypeMember aMembers[])
-            : BaseType<ObjectClass>(aMembers)
+        ObjectType()
         {
         }
 
@@ -297,18 +594,18 @@ namespace Types
         // Allocate a new instance of this ObjectType.
         //
 
-        virtual void InitVariable(MQVarPtr& VarPtr)
+        static void InitVariable(MQVarPtr& VarPtr)
         {
-            VarPtr.Ptr = new ObjectClass();
-        }
+            {
+                Diagnostics::OperationScope operation(ObjectClass::GetTypeName(), "InitVariable");
 
-        //
-        // Register the type with no arguments.
-        //
+                VarPtr.Ptr = new ObjectClass();
+            }
 
-        static void RegisterType()
-        {
-            BaseType<ObjectClass>::RegisterType(new ObjectClass());
+            if (Diagnostics::TraceRecorder::Recording())
+            {
+                Diagnostics::TraceRecorder::InitVariable(ObjectClass::GetTypeName(), VarPtr.Ptr);
+            }
         }
     };
 }
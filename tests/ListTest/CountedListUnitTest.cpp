@@ -0,0 +1,179 @@
+#if defined(UNICODE)
+#undef UNICODE
+#endif
+#if defined(_UNICODE)
+#undef _UNICODE
+#endif
+
+#include "stdafx.h"
+#include "CppUnitTest.h"
+
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "CountedList.h"
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace Collections::Containers;
+
+namespace ListUnitTests
+{
+    //
+    // Test the sequence that backs List against std::list.
+    //
+
+    TEST_CLASS(CountedListUnitTests)
+    {
+    public:
+
+        BEGIN_TEST_CLASS_ATTRIBUTE()
+            TEST_CLASS_ATTRIBUTE(L"Collections", L"List")
+            TEST_CLASS_ATTRIBUTE(L"Containers", L"CountedList")
+        END_TEST_CLASS_ATTRIBUTE()
+
+        //
+        // Apply the same random inserts, erases, sorts and reverses to a
+        // CountedList and a std::list.
+        //
+        // Result: the sequences should stay equal and every position should
+        // find its item and back.
+        //
+
+        TEST_METHOD(RandomOperationsMatchStdList)
+        {
+            CountedList<std::string> counted;
+            std::list<std::string> expected;
+            uint32_t seed = 12345;
+
+            auto next = [&seed](uint32_t bound)
+            {
+                seed = seed * 1103515245 + 12345;
+                return (seed >> 8) % bound;
+            };
+
+            for (size_t operation = 0; operation < 20000; ++operation)
+            {
+                std::string value = std::to_string(next(1000));
+                uint32_t choice = next(100);
+
+                if ((choice < 45) || expected.empty())
+                {
+                    size_t position = next((uint32_t) expected.size() + 1);
+
+                    counted.emplace(counted.nth(position), value);
+                    expected.insert(std::next(expected.begin(), position), value);
+                }
+                else if (choice < 85)
+                {
+                    size_t position = next((uint32_t) expected.size());
+
+                    counted.erase(counted.nth(position));
+                    expected.erase(std::next(expected.begin(), position));
+                }
+                else if (choice < 90)
+                {
+                    counted.pop_front();
+                    expected.pop_front();
+                }
+                else if (choice < 95)
+                {
+                    counted.push_back(value);
+                    expected.push_back(value);
+                }
+                else if (choice < 97)
+                {
+                    auto removed = counted.remove_if([&value](const std::string & item) { return item < value; });
+                    auto before = expected.size();
+
+                    expected.remove_if([&value](const std::string & item) { return item < value; });
+                    Assert::AreEqual(before - expected.size(), removed, L"remove_if should count the items removed.");
+                }
+                else if (choice < 98)
+                {
+                    counted.sort();
+                    expected.sort();
+                }
+                else
+                {
+                    counted.reverse();
+                    expected.reverse();
+                }
+
+                if ((operation % 1000) == 0)
+                {
+                    CheckEqual(counted, expected);
+                }
+            }
+
+            CheckEqual(counted, expected);
+        }
+
+        //
+        // Hold iterators to items while other items are inserted and erased
+        // and the sequence is sorted and reversed.
+        //
+        // Result: the iterators should still refer to their items, as they
+        // would on a std::list.
+        //
+
+        TEST_METHOD(IteratorsSurviveOtherChanges)
+        {
+            CountedList<std::string> counted;
+
+            for (int index = 0; index < 100; ++index)
+            {
+                counted.push_back(std::to_string(index));
+            }
+
+            auto held = counted.nth(50);
+            auto last = counted.nth(99);
+
+            for (int index = 0; index < 50; ++index)
+            {
+                counted.emplace(counted.nth(index * 2), "x" + std::to_string(index));
+                counted.erase(counted.nth(0));
+            }
+
+            Assert::AreEqual(std::string("50"), *held, L"Held item should be unchanged by inserts and erases.");
+            Assert::AreEqual(std::string("99"), *last, L"Last item should be unchanged by inserts and erases.");
+            Assert::AreEqual(counted.size() - 1, counted.index_of(last), L"Last item should still be last.");
+
+            counted.sort();
+            counted.reverse();
+
+            Assert::AreEqual(std::string("50"), *held, L"Held item should be unchanged by sort and reverse.");
+            Assert::IsTrue(counted.nth(counted.index_of(held)) == held, L"Held item should be found at its position.");
+            Assert::IsTrue(++counted.nth(counted.size() - 1) == counted.end(), L"The item after the last should be the end.");
+            Assert::IsTrue(counted.nth(counted.size()) == counted.end(), L"Positions past the last item should be the end.");
+        }
+
+    private:
+
+        //
+        // Check the sequences are equal item by item and by position.
+        //
+
+        void CheckEqual(const CountedList<std::string> & counted, const std::list<std::string> & expected) const
+        {
+            Assert::AreEqual(expected.size(), counted.size(), L"Sizes should match.");
+
+            size_t position = 0;
+            auto it = counted.cbegin();
+
+            for (const auto & item : expected)
+            {
+                Assert::IsTrue(it != counted.cend(), L"CountedList ended early.");
+                Assert::AreEqual(item, *it, L"Items should match.");
+                Assert::IsTrue(counted.nth(position) == it, L"nth should find the item at its position.");
+                Assert::AreEqual(position, counted.index_of(it), L"index_of should return the item's position.");
+
+                ++it;
+                ++position;
+            }
+
+            Assert::IsTrue(it == counted.cend(), L"CountedList should end with the std::list.");
+            Assert::AreEqual(counted.size(), counted.index_of(counted.cend()), L"index_of end should be the size.");
+        }
+    };
+}
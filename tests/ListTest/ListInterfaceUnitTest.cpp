@@ -9,6 +9,10 @@
 #include "CppUnitTest.h"
 
 #include <algorithm>
+#include <cstdint>
+#include <list>
+#include <vector>
+
 #include "List.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -1053,6 +1057,182 @@ namespace ListUnitTests
             Assert::IsFalse(l.Item(l.Count() + 1, &pitem), L"Item beyond end should return false.");
         }
 
+        //
+        // Retrieve items in order, backwards and far apart while the list
+        // is changed by each operation that inserts, erases or moves items.
+        //
+        // Result: each position should return the item at that position
+        // after every change.
+        //
+
+        TEST_METHOD(ItemAfterEachChange)
+        {
+            List l;
+            std::vector<std::string> expected;
+
+            for (int index = 0; index < 200; ++index)
+            {
+                l.Append(std::to_string(index));
+                expected.push_back(std::to_string(index));
+            }
+
+            CompareItems(l, expected);
+
+            std::list<std::string> inserted { "a", "b", "c" };
+            Assert::IsTrue(l.Insert(100, inserted), L"Insert should succeed.");
+            expected.insert(expected.begin() + 100, inserted.cbegin(), inserted.cend());
+            CompareItems(l, expected);
+
+            Assert::IsTrue(l.Erase(50), L"Erase should succeed.");
+            expected.erase(expected.begin() + 50);
+            CompareItems(l, expected);
+
+            Assert::AreEqual((size_t) 1, l.Remove("150"), L"Remove should remove one item.");
+            expected.erase(std::find(expected.begin(), expected.end(), "150"));
+            CompareItems(l, expected);
+
+            std::string item;
+            Assert::IsTrue(l.Head(&item), L"Head should succeed.");
+            expected.erase(expected.begin());
+            CompareItems(l, expected);
+
+            Assert::IsTrue(l.Tail(&item), L"Tail should succeed.");
+            expected.pop_back();
+            CompareItems(l, expected);
+
+            l.Sort();
+            std::sort(expected.begin(), expected.end());
+            CompareItems(l, expected);
+
+            l.Reverse();
+            std::reverse(expected.begin(), expected.end());
+            CompareItems(l, expected);
+
+            l.Clear();
+            expected.clear();
+            CompareItems(l, expected);
+        }
+
+        //
+        // Apply the same random changes to an indexed and an unindexed list.
+        //
+        // Result: Contains, Index, CountOf and Find should answer the same
+        // for both lists after every change.
+        //
+
+        TEST_METHOD(IndexedListMatchesUnindexedList)
+        {
+            List indexed;
+            List plain;
+            uint32_t seed = 2024;
+
+            auto next = [&seed](uint32_t bound)
+            {
+                seed = seed * 1103515245 + 12345;
+                return (seed >> 8) % bound;
+            };
+
+            indexed.SetIndexed(true);
+
+            for (size_t operation = 0; operation < 5000; ++operation)
+            {
+                std::string value = std::to_string(next(40));
+                std::string other = std::to_string(next(40));
+                uint32_t choice = next(100);
+                std::string item;
+
+                if (choice < 30)
+                {
+                    indexed.Append(value);
+                    plain.Append(value);
+                }
+                else if (choice < 50)
+                {
+                    std::list<std::string> sequence { value, other, value };
+                    size_t position = next((uint32_t) plain.Count() + 1);
+
+                    Assert::IsTrue(indexed.Insert(position, sequence), L"Insert should succeed.");
+                    Assert::IsTrue(plain.Insert(position, sequence), L"Insert should succeed.");
+                }
+                else if (choice < 65 && plain.Count() > 0)
+                {
+                    size_t position = next((uint32_t) plain.Count());
+
+                    Assert::IsTrue(indexed.Erase(position), L"Erase should succeed.");
+                    Assert::IsTrue(plain.Erase(position), L"Erase should succeed.");
+                }
+                else if (choice < 72)
+                {
+                    Assert::AreEqual(plain.Head(&item), indexed.Head(&item), L"Head should agree.");
+                }
+                else if (choice < 79)
+                {
+                    Assert::AreEqual(plain.Tail(&item), indexed.Tail(&item), L"Tail should agree.");
+                }
+                else if (choice < 86)
+                {
+                    Assert::AreEqual(plain.Replace(value, other), indexed.Replace(value, other), L"Replace should agree.");
+                }
+                else if (choice < 89)
+                {
+                    Assert::AreEqual(plain.Remove(value), indexed.Remove(value), L"Remove should agree.");
+                }
+                else if (choice < 91)
+                {
+                    std::string removals = value + "," + other + ",1";
+
+                    Assert::AreEqual(Invoke(plain, "RemoveAll", removals).Int,
+                                     Invoke(indexed, "RemoveAll", removals).Int,
+                                     L"RemoveAll should agree.");
+                }
+                else if (choice < 92)
+                {
+                    std::string replacements = value + "=" + other + "," + other + "=" + value + ",2=3";
+
+                    Assert::AreEqual(Invoke(plain, "ReplaceMany", replacements).Int,
+                                     Invoke(indexed, "ReplaceMany", replacements).Int,
+                                     L"ReplaceMany should agree.");
+                }
+                else if (choice < 95)
+                {
+                    indexed.Sort();
+                    plain.Sort();
+                }
+                else if (choice < 98)
+                {
+                    indexed.Reverse();
+                    plain.Reverse();
+                }
+                else if (choice < 99)
+                {
+                    indexed.SetIndexed(false);
+                    indexed.SetIndexed(true);
+                }
+                else
+                {
+                    indexed.Clear();
+                    plain.Clear();
+                }
+
+                for (uint32_t candidate = 0; candidate < 40; candidate += 7)
+                {
+                    std::string query = std::to_string(candidate);
+
+                    Assert::AreEqual(plain.Contains(query), indexed.Contains(query), L"Contains should agree.");
+                    Assert::AreEqual(plain.Index(query), indexed.Index(query), L"Index should agree.");
+                    Assert::AreEqual(plain.CountOf(query), indexed.CountOf(query), L"CountOf should agree.");
+
+                    const std::string * plainValue;
+                    const std::string * indexedValue;
+                    bool plainFound = plain.Find(query)->Value(&plainValue);
+
+                    Assert::AreEqual(plainFound, indexed.Find(query)->Value(&indexedValue), L"Find should agree.");
+                }
+            }
+
+            Assert::AreEqual(plain.Count(), indexed.Count(), L"Counts should agree.");
+        }
+
         //
         // Insert an empty list into an empty list.
         //
@@ -2967,6 +3147,59 @@ namespace ListUnitTests
 
     private:
 
+        //
+        // Call a member of a list through GetMember.
+        //
+
+        MQ2TYPEVAR Invoke(List & l, PCHAR member, const std::string & argument) const
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            std::vector<char> index(argument.cbegin(), argument.cend());
+
+            index.push_back('\0');
+            source.Ptr = &l;
+
+            Assert::IsTrue(List::GetMemberInvoker(source, member, index.data(), dest), L"Member invocation failed.");
+
+            return dest;
+        }
+
+        //
+        // Compare each item of a list with the expected items, visiting
+        // them forwards, backwards and then jumping between the ends.
+        //
+
+        void CompareItems(const List & l, const std::vector<std::string> & expected) const
+        {
+            const std::string * pitem;
+            size_t count = expected.size();
+
+            Assert::AreEqual(count, l.Count(), L"List should have the expected count.");
+
+            for (size_t index = 0; index < count; ++index)
+            {
+                Assert::IsTrue(l.Item(index, &pitem), L"Item should exist.");
+                Assert::AreEqual(expected[index], *pitem, L"Item should match going forwards.");
+            }
+
+            for (size_t index = count; index > 0; --index)
+            {
+                Assert::IsTrue(l.Item(index - 1, &pitem), L"Item should exist.");
+                Assert::AreEqual(expected[index - 1], *pitem, L"Item should match going backwards.");
+            }
+
+            for (size_t index = 0; index < count / 2; ++index)
+            {
+                size_t position = (index % 2 == 0) ? index : count - 1 - index;
+
+                Assert::IsTrue(l.Item(position, &pitem), L"Item should exist.");
+                Assert::AreEqual(expected[position], *pitem, L"Item should match jumping between the ends.");
+            }
+
+            Assert::IsFalse(l.Item(count, &pitem), L"Item at the count should return false.");
+        }
+
         //
         // Append five elements to a list.
         //
@@ -460,7 +460,7 @@ namespace ListUnitTests
         //
 
         void WalkIteratorOverList(const List & l,
-                Collections::ValueIterator<std::list<std::string>> * iterator) const
+                Collections::ValueIterator<Collections::Containers::CountedList<std::string>> * iterator) const
         {
             Assert::IsNotNull(iterator, L"Iterator should not be null.");
             Assert::IsFalse(iterator->IsEnd(), L"Iterator should not be at end.");
@@ -9,6 +9,7 @@
 #include "CppUnitTest.h"
 
 #include "List.h"
+#include "ArgumentCache.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace Collections::Containers;
@@ -130,6 +131,52 @@ namespace ListUnitTests
             Assert::AreEqual(5, dest.Int, L"Count should be zero.");
         }
 
+        //
+        // Call Count using different cases of the member name.
+        //
+        // Result: member names are matched without regard to case.
+        //
+
+        TEST_METHOD(MemberNamesIgnoreCase)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            auto pl = CreateAndAppendUsingGetMember();
+            source.Ptr = pl.get();
+
+            bResult = List::GetMemberInvoker(source, "count", nullptr, dest);
+            Assert::IsTrue(bResult, L"count invocation failed.");
+            Assert::AreEqual(5, dest.Int, L"count should be five.");
+
+            dest.Int = 0;
+            bResult = List::GetMemberInvoker(source, "COUNT", nullptr, dest);
+            Assert::IsTrue(bResult, L"COUNT invocation failed.");
+            Assert::AreEqual(5, dest.Int, L"COUNT should be five.");
+        }
+
+        //
+        // Call members that don't exist, including prefixes and extensions
+        // of real member names.
+        //
+        // Result: the calls fail.
+        //
+
+        TEST_METHOD(UnknownMembersFail)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+
+            auto pl = CreateAndAppendUsingGetMember();
+            source.Ptr = pl.get();
+
+            Assert::IsFalse(List::GetMemberInvoker(source, "Coun", nullptr, dest), L"Coun should not be a member.");
+            Assert::IsFalse(List::GetMemberInvoker(source, "Counts", nullptr, dest), L"Counts should not be a member.");
+            Assert::IsFalse(List::GetMemberInvoker(source, "", nullptr, dest), L"An empty name should not be a member.");
+            Assert::IsFalse(List::GetMemberInvoker(source, "Length", nullptr, dest), L"Length should not be a member.");
+        }
+
         //
         // Call the Clear method on an empty list.
         //
@@ -1152,6 +1199,45 @@ namespace ListUnitTests
             CompareListAndSplice(*pl, 2, splice, 0);
         }
 
+        //
+        // Retrieve a splice starting at a negative index.
+        //
+        // Result: the splice should hold the last two elements.
+        //
+
+        TEST_METHOD(SpliceFromNegativeIndex)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            //
+            // Create a new list.
+            //
+
+            auto pl = CreateAndAppendUsingGetMember();
+
+            //
+            // Set the source pointer to the new instance.
+            //
+
+            source.Ptr = pl.get();
+
+            //
+            // Retrieve a splice of the last two elements.
+            //
+
+            bResult = List::GetMemberInvoker(source, "Splice", "-2", dest);
+            Assert::IsTrue(bResult, L"Splice invocation failed.");
+            Assert::IsNotNull(dest.Ptr, L"Splice should not return a nullptr.");
+
+            std::unique_ptr<List> splice(reinterpret_cast<List *>(dest.Ptr));
+
+            Assert::AreEqual((size_t) 2, splice->Count(), L"Splice must have a length of two.");
+
+            CompareListAndSplice(*pl, 3, splice, 0);
+        }
+
         //
         // Test the list index method on an empty list.
         //
@@ -1448,6 +1534,57 @@ namespace ListUnitTests
             Assert::AreEqual(0, dest.Int,L"Item method should return false.");
         }
 
+        //
+        // Retrieve items using negative indices.
+        //
+        // Result: -1 should be the last item and -Count the first.  An index
+        // before the start of the list should fail.
+        //
+
+        TEST_METHOD(ItemWithNegativeIndex)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            //
+            // Create a new list.
+            //
+
+            auto pl = CreateAndAppendUsingGetMember();
+
+            //
+            // Set the source pointer to the new instance.
+            //
+
+            source.Ptr = pl.get();
+
+            bResult = List::GetMemberInvoker(source, "Item", "-1", dest);
+            Assert::IsTrue(bResult, L"Item invocation failed.");
+            Assert::AreEqual("E", (const char *) dest.Ptr, L"Item -1 should be the last item.");
+
+            bResult = List::GetMemberInvoker(source, "Item", " -5 ", dest);
+            Assert::IsTrue(bResult, L"Item invocation failed.");
+            Assert::AreEqual("A", (const char *) dest.Ptr, L"Item -5 should be the first item.");
+
+            bResult = List::GetMemberInvoker(source, "Item", "+2", dest);
+            Assert::IsTrue(bResult, L"Item invocation failed.");
+            Assert::AreEqual("C", (const char *) dest.Ptr, L"Item +2 should be the third item.");
+
+            dest.Ptr = nullptr;
+            bResult = List::GetMemberInvoker(source, "Item", "-6", dest);
+            Assert::IsTrue(bResult, L"Item invocation failed.");
+            Assert::IsNull(dest.Ptr, L"Item -6 should fail.");
+
+            bResult = List::GetMemberInvoker(source, "Item", "-9223372036854775808", dest);
+            Assert::IsTrue(bResult, L"Item invocation failed.");
+            Assert::IsNull(dest.Ptr, L"Item of the smallest index should fail.");
+
+            bResult = List::GetMemberInvoker(source, "Item", "1x", dest);
+            Assert::IsTrue(bResult, L"Item invocation failed.");
+            Assert::IsNull(dest.Ptr, L"Item with a malformed index should fail.");
+        }
+
         //
         // Insert an empty list into an empty list.
         //
@@ -3509,6 +3646,115 @@ namespace ListUnitTests
             Assert::AreEqual((size_t)0, pl->Count(), L"List must have zero elements.");
         }
 
+        //
+        // Append the same sequence twice, then append it with a different
+        // delimiter.
+        //
+        // Result: the second append is answered from the argument cache and
+        // adds the same items.  The delimiter is part of what is cached, so
+        // the third append splits the sequence on the new delimiter.
+        //
+
+        TEST_METHOD(AppendRepeatedSequenceUsesArgumentCache)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = { 0 };
+            MQ2TYPEVAR old_delim = { 0 };
+            char sequence[] = "cached1,cached2,cached3";
+            char delimiter[] = "|";
+            bool bResult;
+
+            auto pl = std::make_unique<List>();
+            source.Ptr = pl.get();
+
+            Collections::ArgumentCache::Clear();
+            uint64_t hits = Collections::ArgumentCache::Hits();
+            uint64_t misses = Collections::ArgumentCache::Misses();
+
+            bResult = List::GetMemberInvoker(source, "Append", sequence, dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+            Assert::AreEqual(misses + 1, Collections::ArgumentCache::Misses(), L"First append should split the sequence.");
+
+            bResult = List::GetMemberInvoker(source, "Append", sequence, dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+            Assert::AreEqual(hits + 1, Collections::ArgumentCache::Hits(), L"Second append should use the cache.");
+
+            Assert::AreEqual((size_t) 6, pl->Count(), L"List must have six elements.");
+            const std::string * item;
+            Assert::IsTrue(pl->Item(3, &item), L"Item 3 should exist.");
+            Assert::AreEqual(std::string("cached1"), *item, L"Item 3 should be cached1.");
+
+            bResult = List::GetMemberInvoker(source, "Delimiter", delimiter, old_delim);
+            Assert::IsTrue(bResult, L"Delimiter invocation failed.");
+
+            bResult = List::GetMemberInvoker(source, "Append", sequence, dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+            Assert::AreEqual((size_t) 7, pl->Count(), L"List must have seven elements.");
+            Assert::IsTrue(pl->Contains("cached1,cached2,cached3"), L"Sequence should be one item.");
+        }
+
+        //
+        // Append and insert a sequence too long for the argument cache,
+        // with quoted and escaped items.
+        //
+        // Result: the items are added straight from the sequence in order,
+        // each call counts as a miss and nothing is remembered.
+        //
+
+        TEST_METHOD(AppendAndInsertLongSequence)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = { 0 };
+            std::string sequence;
+            const size_t count = 100;
+            bool bResult;
+
+            for (size_t index = 0; index < count; ++index)
+            {
+                sequence += "item" + std::to_string(index) + ",";
+            }
+
+            sequence += "\"quoted,item\",escaped\\,item";
+            Assert::IsTrue(sequence.size() > Collections::ArgumentCache::MaximumLength, L"Sequence should be too long to cache.");
+
+            auto pl = std::make_unique<List>();
+            source.Ptr = pl.get();
+
+            Collections::ArgumentCache::Clear();
+            uint64_t hits = Collections::ArgumentCache::Hits();
+            uint64_t misses = Collections::ArgumentCache::Misses();
+
+            std::vector<char> append(sequence.cbegin(), sequence.cend());
+            append.push_back('\0');
+
+            bResult = List::GetMemberInvoker(source, "Append", append.data(), dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+            Assert::AreEqual(count + 2, pl->Count(), L"List should have every item.");
+
+            std::string insertArguments = "1," + sequence;
+            std::vector<char> insert(insertArguments.cbegin(), insertArguments.cend());
+            insert.push_back('\0');
+
+            bResult = List::GetMemberInvoker(source, "Insert", insert.data(), dest);
+            Assert::IsTrue(bResult, L"Insert invocation failed.");
+            Assert::AreEqual(2 * (count + 2), pl->Count(), L"List should have every item twice.");
+
+            Assert::AreEqual(misses + 2, Collections::ArgumentCache::Misses(), L"Both calls should split the sequence.");
+            Assert::AreEqual(hits, Collections::ArgumentCache::Hits(), L"Neither call should use the cache.");
+
+            const std::string * item;
+            Assert::IsTrue(pl->Item(0, &item), L"Item 0 should exist.");
+            Assert::AreEqual(std::string("item0"), *item, L"Item 0 should be item0.");
+            Assert::IsTrue(pl->Item(1, &item), L"Item 1 should exist.");
+            Assert::AreEqual(std::string("item0"), *item, L"Item 1 should be the first inserted item.");
+            Assert::IsTrue(pl->Item(count + 1, &item), L"Item count + 1 should exist.");
+            Assert::AreEqual(std::string("quoted,item"), *item, L"The quoted item should be one item.");
+            Assert::IsTrue(pl->Item(count + 2, &item), L"Item count + 2 should exist.");
+            Assert::AreEqual(std::string("escaped,item"), *item, L"The escaped item should be one item.");
+            Assert::IsTrue(pl->Item(count + 3, &item), L"Item count + 3 should exist.");
+            Assert::AreEqual(std::string("item1"), *item, L"Item count + 3 should be item1.");
+        }
+
         //
         // Remove an item from an empty list.
         //
@@ -4040,6 +4286,54 @@ namespace ListUnitTests
             CompareListToElements(source, elements, sizeof(elements) / sizeof(elements[0]));
         }
 
+        //
+        // Erase the last item using a negative index.
+        //
+        // Result: erase method should succeed and the last item should be gone.
+        //
+
+        TEST_METHOD(EraseWithNegativeIndex)
+        {
+            PSTR elements[] =
+            {
+                "A",
+                "B",
+                "C",
+                "D"
+            };
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            //
+            // Create a new list.
+            //
+
+            auto pl = CreateAndAppendUsingGetMember();
+
+            //
+            // Set the source pointer to the new instance.
+            //
+
+            source.Ptr = pl.get();
+
+            bResult = List::GetMemberInvoker(source, "Erase", "-1", dest);
+            Assert::IsTrue(bResult, L"Erase invocation failed.");
+            Assert::AreEqual(1, dest.Int, L"Erase should return true.");
+
+            bResult = List::GetMemberInvoker(source, "Erase", "-5", dest);
+            Assert::IsTrue(bResult, L"Erase invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"Erase before the start should return false.");
+
+            Assert::AreEqual((size_t) 4, pl->Count(), L"List must have four elements.");
+
+            //
+            // Verify the elements in the list.
+            //
+
+            CompareListToElements(source, elements, sizeof(elements) / sizeof(elements[0]));
+        }
+
         //
         // Replace an item in an empty list.
         //
@@ -4743,6 +5037,167 @@ namespace ListUnitTests
             }
         }
 
+        //
+        // Turn the index on and off and query the list while it is indexed.
+        //
+        // Result: Indexed should return whether the list is indexed and the
+        // members should answer as they do without the index.
+        //
+
+        TEST_METHOD(IndexedList)
+        {
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            auto pl = CreateAndAppendUsingGetMember();
+            source.Ptr = pl.get();
+
+            bResult = List::GetMemberInvoker(source, "Indexed", nullptr, dest);
+            Assert::IsTrue(bResult, L"Indexed invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"A new list should not be indexed.");
+
+            bResult = List::GetMemberInvoker(source, "Indexed", "true", dest);
+            Assert::IsTrue(bResult, L"Indexed invocation failed.");
+            Assert::AreEqual(1, dest.Int, L"Indexed[true] should index the list.");
+            Assert::IsTrue(pl->IsIndexed(), L"The list should be indexed.");
+
+            bResult = List::GetMemberInvoker(source, "Indexed", "maybe", dest);
+            Assert::IsTrue(bResult, L"Indexed invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"Indexed should return FALSE for an argument that isn't a boolean.");
+            Assert::IsTrue(pl->IsIndexed(), L"The list should still be indexed.");
+
+            bResult = List::GetMemberInvoker(source, "Append", "C,F", dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+
+            bResult = List::GetMemberInvoker(source, "CountOf", "C", dest);
+            Assert::IsTrue(bResult, L"CountOf invocation failed.");
+            Assert::AreEqual(2, dest.Int, L"CountOf should count the appended item.");
+
+            bResult = List::GetMemberInvoker(source, "Contains", "F", dest);
+            Assert::IsTrue(bResult, L"Contains invocation failed.");
+            Assert::AreEqual(1, dest.Int, L"The list should contain the appended item.");
+
+            bResult = List::GetMemberInvoker(source, "Erase", "2", dest);
+            Assert::IsTrue(bResult, L"Erase invocation failed.");
+
+            bResult = List::GetMemberInvoker(source, "Index", "C", dest);
+            Assert::IsTrue(bResult, L"Index invocation failed.");
+            Assert::AreEqual(4, dest.Int, L"Index should find the remaining C.");
+
+            bResult = List::GetMemberInvoker(source, "Replace", "C,A", dest);
+            Assert::IsTrue(bResult, L"Replace invocation failed.");
+            Assert::AreEqual(1, dest.Int, L"Replace should replace one item.");
+
+            bResult = List::GetMemberInvoker(source, "CountOf", "A", dest);
+            Assert::IsTrue(bResult, L"CountOf invocation failed.");
+            Assert::AreEqual(2, dest.Int, L"CountOf should count the replaced item.");
+
+            bResult = List::GetMemberInvoker(source, "Index", "C", dest);
+            Assert::IsTrue(bResult, L"Index invocation failed.");
+            Assert::AreEqual(-1, dest.Int, L"Index should not find a replaced item.");
+
+            bResult = List::GetMemberInvoker(source, "ReplaceMany", "C=A,Z=A", dest);
+            Assert::IsTrue(bResult, L"ReplaceMany invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"ReplaceMany should replace nothing when no source is in the list.");
+            Assert::IsTrue(dest.Type == mq::datatypes::pIntType, L"ReplaceMany should return a count when no source is in the list.");
+
+            bResult = List::GetMemberInvoker(source, "ReplaceMany", "C=A,Z", dest);
+            Assert::IsTrue(bResult, L"ReplaceMany invocation failed.");
+            Assert::IsTrue(dest.Type == mq::datatypes::pBoolType, L"ReplaceMany should return FALSE for a pair without =.");
+
+            bResult = List::GetMemberInvoker(source, "Indexed", "FALSE", dest);
+            Assert::IsTrue(bResult, L"Indexed invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"Indexed[FALSE] should stop indexing the list.");
+            Assert::IsFalse(pl->IsIndexed(), L"The list should not be indexed.");
+
+            bResult = List::GetMemberInvoker(source, "CountOf", "A", dest);
+            Assert::IsTrue(bResult, L"CountOf invocation failed.");
+            Assert::AreEqual(2, dest.Int, L"CountOf should count without the index.");
+        }
+
+        //
+        // Remove several items, some repeated and some not in the list, in
+        // one call.
+        //
+        // Result: every occurrence of each item should be removed and the
+        // count of removed items returned.
+        //
+
+        TEST_METHOD(RemoveAllItems)
+        {
+            PSTR elements[] =
+            {
+                "B",
+                "D"
+            };
+
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            auto pl = CreateAndAppendUsingGetMember();
+            source.Ptr = pl.get();
+
+            bResult = List::GetMemberInvoker(source, "Append", "A,C,E,A", dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+
+            bResult = List::GetMemberInvoker(source, "RemoveAll", "A,C,E,Z,A", dest);
+            Assert::IsTrue(bResult, L"RemoveAll invocation failed.");
+            Assert::AreEqual(7, dest.Int, L"RemoveAll should remove seven items.");
+            Assert::AreEqual((size_t) 2, pl->Count(), L"List must have two elements.");
+
+            CompareListToElements(source, elements, sizeof(elements) / sizeof(elements[0]));
+
+            bResult = List::GetMemberInvoker(source, "RemoveAll", "Z", dest);
+            Assert::IsTrue(bResult, L"RemoveAll invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"RemoveAll should remove nothing.");
+        }
+
+        //
+        // Replace several items in one call, including swapping two items.
+        //
+        // Result: each item should be replaced by its target as it was
+        // before the call and the count of replaced items returned.
+        //
+
+        TEST_METHOD(ReplaceManyItems)
+        {
+            PSTR elements[] =
+            {
+                "B",
+                "A",
+                "C",
+                "X",
+                "E",
+                "B"
+            };
+
+            MQ2VARPTR source;
+            MQ2TYPEVAR dest = {0};
+            bool bResult;
+
+            auto pl = CreateAndAppendUsingGetMember();
+            source.Ptr = pl.get();
+
+            bResult = List::GetMemberInvoker(source, "Append", "A", dest);
+            Assert::IsTrue(bResult, L"Append invocation failed.");
+
+            bResult = List::GetMemberInvoker(source, "ReplaceMany", "A=B,B=A,D=X,Z=Y", dest);
+            Assert::IsTrue(bResult, L"ReplaceMany invocation failed.");
+            Assert::AreEqual(4, dest.Int, L"ReplaceMany should replace four items.");
+            Assert::AreEqual((size_t) 6, pl->Count(), L"List must have six elements.");
+
+            CompareListToElements(source, elements, sizeof(elements) / sizeof(elements[0]));
+
+            bResult = List::GetMemberInvoker(source, "ReplaceMany", "B=Q,C", dest);
+            Assert::IsTrue(bResult, L"ReplaceMany invocation failed.");
+            Assert::AreEqual(0, dest.Int, L"ReplaceMany should fail for a pair without =.");
+            Assert::AreEqual((size_t) 6, pl->Count(), L"List must still have six elements.");
+
+            CompareListToElements(source, elements, sizeof(elements) / sizeof(elements[0]));
+        }
+
     private:
 
         //
@@ -960,6 +960,119 @@ namespace ListUnitTests
             Assert::IsTrue(iterdest.Int, L"Clone IsEnd should return True.");
         }
 
+        //
+        // Keep the iterator from First in a variable, then call First again
+        // for a nested loop, as:
+        //
+        //      /vardata outer l.First
+        //      /vardata inner l.First
+        //
+        // Result: the outer iterator should be unaffected by the inner one
+        // and each should be freed with its variable.
+        //
+
+        TEST_METHOD(NestedIteratorsFromFirst)
+        {
+            MQ2VARPTR source;
+            MQ2VARPTR outer;
+            MQ2VARPTR inner;
+            MQ2TYPEVAR dest = {0};
+            MQ2TYPEVAR iterdest = {0};
+            bool bResult;
+
+            source.Ptr = &_l;
+            outer.Ptr = nullptr;
+            inner.Ptr = nullptr;
+
+            bResult = List::GetMemberInvoker(source, "First", nullptr, dest);
+            Assert::IsTrue(bResult, L"First invocation failed.");
+            Assert::IsTrue(ListIterator::FromData(outer, dest), L"Outer FromData failed.");
+
+            ListIterator::GetMemberInvoker(outer, "Advance", nullptr, iterdest);
+            ListIterator::GetMemberInvoker(outer, "Advance", nullptr, iterdest);
+
+            bResult = List::GetMemberInvoker(source, "First", nullptr, dest);
+            Assert::IsTrue(bResult, L"First invocation failed.");
+            Assert::AreNotEqual(outer.Ptr, dest.Ptr, L"First should return a new iterator.");
+            Assert::IsTrue(ListIterator::FromData(inner, dest), L"Inner FromData failed.");
+
+            bResult = ListIterator::GetMemberInvoker(outer, "Value", nullptr, iterdest);
+            Assert::IsTrue(bResult, L"Outer Value invocation failed.");
+            Assert::AreEqual("C", (const char *) iterdest.Ptr, false, L"Outer iterator moved.");
+
+            bResult = ListIterator::GetMemberInvoker(inner, "Value", nullptr, iterdest);
+            Assert::IsTrue(bResult, L"Inner Value invocation failed.");
+            Assert::AreEqual("A", (const char *) iterdest.Ptr, false, L"Inner iterator should be at the start.");
+
+            size_t live = ListIterator::LiveInstances();
+
+            ListIterator::FreeVariable(outer);
+            Assert::AreEqual(live - 1, ListIterator::LiveInstances(), L"Outer iterator should be deleted.");
+
+            //
+            // The list still holds the inner iterator it returned last.
+            //
+
+            ListIterator::FreeVariable(inner);
+            Assert::AreEqual(live - 1, ListIterator::LiveInstances(), L"Inner iterator is still held by the list.");
+        }
+
+        //
+        // Share one iterator between two variables and delete one of them
+        // after the list has moved on to another iterator, as:
+        //
+        //      /vardata a l.First
+        //      /vardata b a
+        //      /vardata c l.First
+        //      /deletevar a
+        //
+        // Result: the iterator should stay alive for b and be deleted with
+        // it.
+        //
+
+        TEST_METHOD(IteratorSharedByTwoVariables)
+        {
+            MQ2VARPTR source;
+            MQ2VARPTR a;
+            MQ2VARPTR b;
+            MQ2VARPTR c;
+            MQ2TYPEVAR dest = {0};
+            MQ2TYPEVAR iterdest = {0};
+            bool bResult;
+
+            source.Ptr = &_l;
+            a.Ptr = nullptr;
+            b.Ptr = nullptr;
+            c.Ptr = nullptr;
+
+            bResult = List::GetMemberInvoker(source, "First", nullptr, dest);
+            Assert::IsTrue(bResult, L"First invocation failed.");
+            Assert::IsTrue(ListIterator::FromData(a, dest), L"FromData into a failed.");
+
+            MQ2TYPEVAR shared = dest;
+            shared.Ptr = a.Ptr;
+            Assert::IsTrue(ListIterator::FromData(b, shared), L"FromData into b failed.");
+
+            bResult = List::GetMemberInvoker(source, "First", nullptr, dest);
+            Assert::IsTrue(bResult, L"First invocation failed.");
+            Assert::IsTrue(ListIterator::FromData(c, dest), L"FromData into c failed.");
+
+            size_t live = ListIterator::LiveInstances();
+
+            ListIterator::FreeVariable(a);
+            Assert::AreEqual(live, ListIterator::LiveInstances(), L"The shared iterator should still be alive for b.");
+
+            bResult = ListIterator::GetMemberInvoker(b, "Value", nullptr, iterdest);
+            Assert::IsTrue(bResult, L"Value invocation through b failed.");
+            Assert::AreEqual("A", (const char *) iterdest.Ptr, false, L"b should still be at the start.");
+
+            ListIterator::FreeVariable(b);
+            Assert::AreEqual(live - 1, ListIterator::LiveInstances(), L"The shared iterator should be deleted with b.");
+
+            ListIterator::FreeVariable(c);
+            Assert::AreEqual(live - 1, ListIterator::LiveInstances(), L"c's iterator is still held by the list.");
+        }
+
     private:
         //
         // Acquire an iterator and walk through each element using the GetMember
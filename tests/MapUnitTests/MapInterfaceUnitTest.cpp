@@ -249,6 +249,36 @@ namespace MapUnitTests
             Assert::AreEqual((size_t) 1, m.Count(), L"Map should have a size of one.");
         }
 
+        //
+        // Look up, replace and remove a key given as a view into a larger
+        // string.
+        //
+        // Result: only the viewed characters should be used as the key.
+        //
+
+        TEST_METHOD(KeysAsStringViews)
+        {
+            Map m;
+            std::string text("xAy=Value2");
+            std::string_view key(text.data() + 1, 1);
+            std::string_view value(text.data() + 4, 6);
+            const std::string * found;
+
+            m.Add("A", "Value1");
+            m.Add(key, value);
+
+            Assert::AreEqual((size_t) 1, m.Count(), L"Map should have a size of one.");
+            Assert::IsTrue(m.Contains(key), L"Expected map to contain element 'A'.");
+            Assert::IsFalse(m.Contains(std::string_view(text.data(), 2)), L"Map should not contain 'xA'.");
+
+            auto iterator = m.Find(key);
+            Assert::IsTrue(iterator->Value(&found), L"Find should return the element.");
+            Assert::AreEqual(std::string("Value2"), *found, L"Value should have been replaced.");
+
+            Assert::IsTrue(m.Remove(key), L"Remove should succeed.");
+            Assert::AreEqual((size_t) 0, m.Count(), L"Map should be empty.");
+        }
+
     private:
         //
         // Insert three elements into a map.
@@ -449,7 +449,7 @@ namespace MapUnitTests
         //
 
         void WalkIteratorOverMap(const Map & m,
-            Collections::KeyValueIterator<std::map<std::string, std::string>,
+            Collections::KeyValueIterator<std::map<std::string, std::string, std::less<>>,
                                                           std::string,
                                                           std::string> * iterator
         ) const
@@ -190,6 +190,37 @@ namespace QueueUnitTests
             EmptyTest(q);
         }
 
+        //
+        // Peek and pop without copying the elements.
+        //
+        // Result: peek should point at the element held by the queue and
+        // pop should move each element out in order.
+        //
+
+        TEST_METHOD(TestPeekAndPopWithoutCopies)
+        {
+            Queue q;
+            const std::string * held;
+            std::string element;
+
+            PushThree(&q);
+
+            Assert::IsTrue(q.Peek(&held));
+            Assert::AreEqual(std::string("A"), *held);
+
+            Assert::IsTrue(q.Pop(&element));
+            Assert::AreEqual(std::string("A"), element);
+            Assert::IsTrue(q.Pop(&element));
+            Assert::AreEqual(std::string("B"), element);
+            Assert::IsTrue(q.Pop(&element));
+            Assert::AreEqual(std::string("C"), element);
+
+            Assert::IsFalse(q.Peek(&held));
+            Assert::IsFalse(q.Pop(&element));
+            Assert::AreEqual(std::string("C"), element);
+            EmptyTest(q);
+        }
+
     private:
         //
         // Push three elements onto a queue.
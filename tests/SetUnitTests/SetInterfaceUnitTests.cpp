@@ -309,6 +309,37 @@ namespace SetUnitTests
             Assert::AreEqual((size_t) 1, s.Count(), L"Set should have a size of one.");
         }
 
+        //
+        // Look up, add and remove an element given as a view into a larger
+        // string.
+        //
+        // Result: only the viewed characters should be used as the element.
+        //
+
+        TEST_METHOD(ElementsAsStringViews)
+        {
+            Set s;
+            std::string text("xBy");
+            std::string_view item(text.data() + 1, 1);
+            const std::string * found;
+
+            InsertElements(&s);
+
+            Assert::IsTrue(s.Contains(item), L"Expected set to contain 'B'.");
+            Assert::IsFalse(s.Contains(std::string_view(text.data(), 2)), L"Set should not contain 'xB'.");
+
+            s.Add(item);
+            Assert::AreEqual((size_t) 3, s.Count(), L"Set should have a size of three.");
+
+            auto iterator = s.Find(item);
+            Assert::IsTrue(iterator->Value(&found), L"Find should return the element.");
+            Assert::AreEqual(std::string("B"), *found, L"Find should return 'B'.");
+
+            Assert::IsTrue(s.Remove(item), L"Remove should succeed.");
+            Assert::IsFalse(s.Contains("B"), L"Set should not contain 'B'.");
+            Assert::AreEqual((size_t) 2, s.Count(), L"Set should have a size of two.");
+        }
+
     private:
         //
         // Insert three elements into a set.
@@ -204,7 +204,7 @@ namespace SetUnitTests
         //
 
         void WalkIteratorOverSet(const Set & s,
-            Collections::ValueIterator<std::set<std::string>> * iterator
+            Collections::ValueIterator<std::set<std::string, std::less<>>> * iterator
         ) const
         {
             Assert::IsNotNull(iterator, L"Iterator should not be null.");
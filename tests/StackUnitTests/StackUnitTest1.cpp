@@ -194,6 +194,37 @@ namespace StackUnitTests
             EmptyTest(s);
         }
 
+        //
+        // Peek and pop without copying the elements.
+        //
+        // Result: peek should point at the element held by the stack and
+        // pop should move each element out in order.
+        //
+
+        TEST_METHOD(TestPeekAndPopWithoutCopies)
+        {
+            Stack s;
+            const std::string * held;
+            std::string element;
+
+            PushThree(&s);
+
+            Assert::IsTrue(s.Peek(&held));
+            Assert::AreEqual(std::string("C"), *held);
+
+            Assert::IsTrue(s.Pop(&element));
+            Assert::AreEqual(std::string("C"), element);
+            Assert::IsTrue(s.Pop(&element));
+            Assert::AreEqual(std::string("B"), element);
+            Assert::IsTrue(s.Pop(&element));
+            Assert::AreEqual(std::string("A"), element);
+
+            Assert::IsFalse(s.Peek(&held));
+            Assert::IsFalse(s.Pop(&element));
+            Assert::AreEqual(std::string("A"), element);
+            EmptyTest(s);
+        }
+
     private:
         //
         // Push three elements onto a stack.
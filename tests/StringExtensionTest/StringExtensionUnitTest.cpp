@@ -6,6 +6,7 @@
 #include <list>
 #include <memory>
 
+#include "Conversions.h"
 #include "StringExtensions.h"
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
@@ -290,6 +291,30 @@ namespace StringExtensionTest
                     '"'),
                 L"Expected to contain one quotation mark.");
         }
+
+        //
+        // Test a string longer than the scanner's blocks with separators,
+        // quotes and escapes on either side of the block boundaries.
+        //
+        // Result: the items are the same as scanning a character at a time.
+        //
+
+        TEST_METHOD(SplitAcrossBlockBoundaries)
+        {
+            std::string padding(29, 'x');
+            StringExtensions extension(padding + ",ab\\,c\"" + padding + ",\\\"\",d" + padding + "\\");
+            std::unique_ptr<StringExtensions::container_type> container;
+
+            container.reset(extension.Split(std::string(",")).release());
+
+            Assert::AreEqual((size_t)3,
+                container->size(),
+                L"Expected Split() to return 3 elements.");
+
+            Assert::AreEqual(padding, container->at(0));
+            Assert::AreEqual(std::string("ab,c") + padding + ",\"", container->at(1));
+            Assert::AreEqual(std::string("d") + padding, container->at(2));
+        }
     };
 
     //
@@ -814,5 +839,260 @@ namespace StringExtensionTest
             Assert::IsFalse(FromString(std::string("   78910a  "), &lResult));
             Assert::AreEqual(-1L, lResult, L"Expected -1 returned");
         }
+
+        TEST_METHOD(ParseIntegerRange)
+        {
+            const char text[] = "12,-34";
+            int64_t result = 0;
+            size_t index = 7;
+
+            Assert::IsTrue(ParseInteger(text, text + 2, &result));
+            Assert::AreEqual((int64_t) 12, result, L"Expected 12 returned");
+
+            Assert::IsTrue(ParseInteger(text + 3, text + 6, &result));
+            Assert::AreEqual((int64_t) -34, result, L"Expected -34 returned");
+
+            Assert::IsTrue(ParseInteger(" +5\t", &result));
+            Assert::AreEqual((int64_t) 5, result, L"Expected 5 returned");
+
+            result = -1;
+            Assert::IsFalse(ParseInteger("", &result));
+            Assert::IsFalse(ParseInteger("   ", &result));
+            Assert::IsFalse(ParseInteger("+", &result));
+            Assert::IsFalse(ParseInteger("+-5", &result));
+            Assert::IsFalse(ParseInteger("5 5", &result));
+            Assert::IsFalse(ParseInteger("99999999999999999999", &result));
+            Assert::AreEqual((int64_t) -1, result, L"Expected -1 returned");
+
+            Assert::IsFalse(ParseInteger("-1", &index));
+            Assert::AreEqual((size_t) 7, index, L"Expected 7 returned");
+        }
+    };
+
+    //
+    // Test conversions of integers to strings.
+    //
+
+    TEST_CLASS(ConversionsToString)
+    {
+    public:
+        BEGIN_TEST_CLASS_ATTRIBUTE()
+            TEST_CLASS_ATTRIBUTE(L"StringExtentions", L"Conversions To String")
+        END_TEST_CLASS_ATTRIBUTE()
+
+        //
+        // Format values of several types and radices.
+        //
+        // Result: the digits should match the value.
+        //
+
+        TEST_METHOD(FormatValues)
+        {
+            char buffer[80];
+
+            Assert::AreEqual(0, (int) Conversions::ToString((size_t) 0, buffer, sizeof(buffer)));
+            Assert::AreEqual("0", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString((size_t) 1234567, buffer, sizeof(buffer)));
+            Assert::AreEqual("1234567", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString(UINT64_MAX, buffer, sizeof(buffer)));
+            Assert::AreEqual("18446744073709551615", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString(INT64_MIN, buffer, sizeof(buffer)));
+            Assert::AreEqual("-9223372036854775808", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString(-42, buffer, sizeof(buffer)));
+            Assert::AreEqual("-42", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString(255, buffer, sizeof(buffer), 16));
+            Assert::AreEqual("ff", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString((int8_t) -1, buffer, sizeof(buffer), 2));
+            Assert::AreEqual("11111111", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString(46655, buffer, sizeof(buffer), 36));
+            Assert::AreEqual("zzz", (const char *) buffer);
+
+            Assert::AreEqual(0, (int) Conversions::ToString(100, buffer, sizeof(buffer), 3));
+            Assert::AreEqual("10201", (const char *) buffer);
+        }
+
+        //
+        // Format into buffers that are too short and with bad radices.
+        //
+        // Result: ERANGE or EINVAL should be returned and the buffer should
+        // be empty.
+        //
+
+        TEST_METHOD(FormatErrors)
+        {
+            char buffer[4];
+
+            Assert::AreEqual(0, (int) Conversions::ToString(999, buffer, sizeof(buffer)));
+            Assert::AreEqual("999", (const char *) buffer);
+
+            Assert::AreEqual((int) ERANGE, (int) Conversions::ToString(1000, buffer, sizeof(buffer)));
+            Assert::AreEqual("", (const char *) buffer);
+
+            Assert::AreEqual((int) ERANGE, (int) Conversions::ToString(-100, buffer, sizeof(buffer)));
+            Assert::AreEqual("", (const char *) buffer);
+
+            Assert::AreEqual((int) EINVAL, (int) Conversions::ToString(1, buffer, sizeof(buffer), 1));
+            Assert::AreEqual((int) EINVAL, (int) Conversions::ToString(1, buffer, sizeof(buffer), 37));
+            Assert::AreEqual((int) EINVAL, (int) Conversions::ToString(1, nullptr, 10));
+        }
+    };
+
+    //
+    // Test scanning for a set of characters.
+    //
+
+    TEST_CLASS(DelimiterScannerFind)
+    {
+    public:
+        BEGIN_TEST_CLASS_ATTRIBUTE()
+            TEST_CLASS_ATTRIBUTE(L"StringExtentions", L"Delimiter Scanner")
+        END_TEST_CLASS_ATTRIBUTE()
+
+        //
+        // Find the first character of a small set and of a set too large to
+        // scan a block at a time, starting from every offset of a string
+        // longer than the blocks.
+        //
+        // Result: Find should return the same position as a scan one
+        // character at a time.
+        //
+
+        TEST_METHOD(FindFromEveryOffset)
+        {
+            std::string text(100, 'a');
+
+            text[3] = ',';
+            text[40] = '\0';
+            text[71] = (char) 0xff;
+            text[99] = ';';
+
+            for (const std::string & characters : { std::string(","), std::string(";\xff", 2), std::string(",;\0\xff\"\\bcdefg", 12) })
+            {
+                DelimiterScanner scanner(characters.data(), characters.size());
+
+                for (size_t offset = 0; offset <= text.size(); ++offset)
+                {
+                    const char * first = text.data() + offset;
+                    const char * last = text.data() + text.size();
+                    const char * expected = first;
+
+                    while ((expected != last) && (characters.find(*expected) == std::string::npos))
+                    {
+                        ++expected;
+                    }
+
+                    Assert::IsTrue(expected == scanner.Find(first, last), L"Find should return the first character in the set.");
+                }
+            }
+        }
+
+        //
+        // Add characters to a set, including duplicates.
+        //
+        // Result: only the characters added should be in the set.
+        //
+
+        TEST_METHOD(ContainsAddedCharacters)
+        {
+            DelimiterScanner scanner(",,", 2);
+
+            scanner.Add("\\\"", 2);
+
+            Assert::IsTrue(scanner.Contains(','));
+            Assert::IsTrue(scanner.Contains('\\'));
+            Assert::IsTrue(scanner.Contains('"'));
+            Assert::IsFalse(scanner.Contains(' '));
+            Assert::IsFalse(scanner.Contains('\0'));
+        }
+    };
+
+    //
+    // Test splitting into views of the argument.
+    //
+
+    TEST_CLASS(StringExtensionSplitItems)
+    {
+    public:
+        BEGIN_TEST_CLASS_ATTRIBUTE()
+            TEST_CLASS_ATTRIBUTE(L"StringExtentions", L"Split Items")
+        END_TEST_CLASS_ATTRIBUTE()
+
+        //
+        // Split a string without quotes or escapes.
+        //
+        // Result: every item should be a view of the string.
+        //
+
+        TEST_METHOD(SplitPlainItemsIntoViews)
+        {
+            std::string text("one,two,,three");
+            SplitItems items;
+
+            items.Split(text, ",");
+
+            Assert::AreEqual((size_t) 4, items.size(), L"Expected Split() to return 4 elements.");
+            Assert::IsTrue(items[0] == "one");
+            Assert::IsTrue(items[1] == "two");
+            Assert::IsTrue(items[2].empty());
+            Assert::IsTrue(items[3] == "three");
+
+            for (const auto & item : items)
+            {
+                Assert::IsTrue((item.data() >= text.data()) && (item.data() <= text.data() + text.size()),
+                    L"Expected the item to be a view of the string.");
+            }
+        }
+
+        //
+        // Split a string with quoted and escaped items, trimming each item.
+        //
+        // Result: the items should match StringExtensions::Split, trimmed.
+        //
+
+        TEST_METHOD(SplitQuotedItemsAndTrim)
+        {
+            std::string text(" \"a, b\" ,c\\,d,  e  ,\" f \"");
+            SplitItems items;
+
+            items.Split(text, ",", true);
+
+            Assert::AreEqual((size_t) 4, items.size(), L"Expected Split() to return 4 elements.");
+            Assert::IsTrue(items[0] == "a, b");
+            Assert::IsTrue(items[1] == "c,d");
+            Assert::IsTrue(items[2] == "e");
+            Assert::IsTrue(items[3] == "f");
+
+            auto expected = StringExtensions(text).Split(std::string(","));
+
+            items.Split(text, ",");
+
+            Assert::AreEqual(expected->size(), items.size(), L"Expected the same number of items as Split().");
+            for (size_t index = 0; index < items.size(); ++index)
+            {
+                Assert::AreEqual(expected->at(index), std::string(items[index]));
+            }
+        }
+
+        //
+        // Trim views of a string.
+        //
+        // Result: the views should exclude the trimmed characters.
+        //
+
+        TEST_METHOD(TrimViews)
+        {
+            Assert::IsTrue(TrimView(" \t a b \r\n") == "a b");
+            Assert::IsTrue(TrimView("ab") == "ab");
+            Assert::IsTrue(TrimView(" \t ").empty());
+            Assert::IsTrue(TrimView("").empty());
+            Assert::IsTrue(TrimView("xxaxx", "x") == "a");
+        }
     };
 }